@@ -0,0 +1,51 @@
+#!/usr/bin/env python
+"""Measures the cost of gi.profiler on calls of introspected functions.
+
+Run it against a default build and one configured with --disable-profiler,
+which compiles the profiler checks out: the difference of the "disabled"
+columns is what the checks cost while the profiler is off. The "enabled"
+column shows the cost of recording.
+"""
+
+from __future__ import print_function
+
+import sys
+import timeit
+
+import gi.profiler
+from gi.repository import GLib
+
+N = 1000000
+REPEAT = 5
+
+CALLS = [
+    ('GLib.get_monotonic_time()', GLib.get_monotonic_time, ()),
+    ('GLib.random_int_range(0, 10)', GLib.random_int_range, (0, 10)),
+    ('GLib.path_get_basename("/a/b")', GLib.path_get_basename, ('/a/b',)),
+]
+
+
+def measure(function, args, n):
+    timer = timeit.Timer(lambda: function(*args))
+    return min(timer.repeat(REPEAT, n)) / n * 1e9
+
+
+def main():
+    n = int(sys.argv[1]) if len(sys.argv) > 1 else N
+
+    print('%-34s %12s %12s' % ('call (ns per call)', 'disabled', 'enabled'))
+    for name, function, args in CALLS:
+        gi.profiler.disable()
+        disabled = measure(function, args, n)
+        if gi.profiler.is_available():
+            gi.profiler.enable()
+            enabled = '%12.1f' % measure(function, args, n)
+            gi.profiler.disable()
+            gi.profiler.reset()
+        else:
+            enabled = '%12s' % '-'
+        print('%-34s %12.1f %s' % (name, disabled, enabled))
+
+
+if __name__ == '__main__':
+    main()
@@ -145,6 +145,62 @@ def get_required_version(namespace):
     return _versions.get(namespace, None)
 
 
+def set_gil_release(function, release):
+    """Set whether the GIL is released while calling an introspected function.
+
+    :param function:
+        Introspected function or method (e.g. ``Gtk.Widget.get_visible``)
+    :param bool release:
+        True to let other Python threads run during the call
+
+    By default the GIL is kept for simple getters and released for all other
+    functions. Functions which can block or call back into Python from other
+    threads must keep releasing the GIL. Overrides can use this to adjust
+    the policy for functions of their namespace.
+
+    :raises: TypeError if function is not an introspected function
+    """
+    _gi.set_gil_release(function, release)
+
+
+def get_gil_release(function):
+    """Returns whether the GIL is released while calling function.
+
+    See :func:`set_gil_release`.
+    """
+    return _gi.get_gil_release(function)
+
+
+def invoke_many(function, args):
+    """Call an introspected function once for each argument sequence.
+
+    :param function:
+        Introspected function or bound method
+    :param args:
+        Iterable of argument sequences, one per call
+    :returns: list of the results of the calls
+
+    For functions which don't take ownership of their arguments, take no
+    callbacks and have no caller allocated out arguments the calls are made
+    in batches of 64: the arguments of all calls of a batch are converted
+    first, then the C calls are made with the GIL released only once, then
+    the results are converted. This differs from
+    ``[function(*a) for a in args]`` when an error occurs:
+
+    - If the arguments of a call can't be converted, no call of its batch is
+      made, while the calls of the previous batches already happened.
+    - If a call fails (e.g. raises a GLib.Error), the remaining calls of its
+      batch already happened; the first error is raised and no further
+      batch is started.
+
+    Other functions are called one at a time, stopping at the first error.
+    The results are only returned if all calls succeeded.
+
+    :raises: TypeError if function is not an introspected function
+    """
+    return _gi.invoke_many(function, args)
+
+
 def require_foreign(namespace, symbol=None):
     """Ensure the given foreign marshaling module is available and loaded.
 
@@ -169,3 +225,11 @@ def require_foreign(namespace, symbol=None):
     except Exception as e:
         raise ImportError(str(e))
     importlib.import_module('gi.repository', namespace)
+
+
+if os.environ.get('PYGI_PROFILE', '0') not in ('', '0'):
+    import atexit
+    from . import profiler
+    if profiler.is_available():
+        profiler.enable()
+        atexit.register(profiler.dump)
@@ -47,6 +47,11 @@ else:
     _basestring = basestring
     _long = long
 
+# GParamFlags bits checked by the Property.__set__ fast path.
+_PARAM_WRITABLE = 1 << 1
+_PARAM_CONSTRUCT_ONLY = 1 << 3
+_PARAM_EXPLICIT_NOTIFY = 1 << 30
+
 
 class Property(object):
     """Creates a new Property which when used in conjunction with
@@ -207,6 +212,7 @@ class Property(object):
         self.maximum = maximum
 
         self._exc = None
+        self._fast_set = self._get_fast_set()
 
     def __repr__(self):
         return '<GObject Property %s (%s)>' % (
@@ -243,7 +249,23 @@ class Property(object):
             raise TypeError
 
         self._exc = None
-        instance.set_property(self.name, value)
+
+        # Values which would come out of a GValue unchanged are handed to
+        # fset directly, skipping the GValue conversion and the
+        # do_set_property dispatch; notify is emitted the same way
+        # g_object_set_property() would emit it.
+        fast_set = self._fast_set
+        if (fast_set is not None and fast_set(value) and
+                getattr(getattr(type(instance), 'do_set_property', None),
+                        '_property_helper', False)):
+            try:
+                self.fset(instance, value)
+            except Exception:
+                traceback.print_exc()
+            instance.notify(self.name)
+        else:
+            instance.set_property(self.name, value)
+
         if self._exc:
             exc = self._exc
             self._exc = None
@@ -272,6 +294,35 @@ class Property(object):
             self.name = self.fget.__name__
         return self
 
+    def _get_fast_set(self):
+        """Returns a predicate telling whether a value can bypass the GValue
+        conversion in __set__, or None if it never can."""
+        flags = int(self.flags)
+        if (not flags & _PARAM_WRITABLE or flags & _PARAM_CONSTRUCT_ONLY or
+                flags & _PARAM_EXPLICIT_NOTIFY):
+            return None
+
+        ptype = self.type
+        minimum, maximum = self.minimum, self.maximum
+        if ptype == TYPE_PYOBJECT:
+            return lambda value: True
+        elif ptype == TYPE_BOOLEAN:
+            return lambda value: type(value) is bool
+        elif ptype == TYPE_STRING:
+            return lambda value: type(value) is str and '\0' not in value
+        elif ptype == TYPE_DOUBLE:
+            return lambda value: (type(value) is float and
+                                  minimum <= value <= maximum)
+        elif ptype in (TYPE_INT, TYPE_UINT, TYPE_LONG, TYPE_ULONG,
+                       TYPE_INT64, TYPE_UINT64):
+            return lambda value: (type(value) in (int, _long) and
+                                  minimum <= value <= maximum)
+        elif ptype.is_a(TYPE_OBJECT):
+            return lambda value: (value is None or
+                                  (isinstance(value, _gobject.GObject) and
+                                   value.__gtype__.is_a(ptype)))
+        return None
+
     def _type_from_python(self, type_):
         if type_ in self._type_from_pytype_lookup:
             return self._type_from_pytype_lookup[type_]
@@ -425,4 +476,5 @@ def install_properties(cls):
         prop = getattr(cls, name, None)
         if prop:
             prop.fset(self, value)
+    obj_set_property._property_helper = True
     cls.do_set_property = obj_set_property
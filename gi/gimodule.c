@@ -41,6 +41,8 @@
 #include "pygi-boxed.h"
 #include "pygi-info.h"
 #include "pygi-struct.h"
+#include "pygi-invoke.h"
+#include "pygi-profiler.h"
 
 #include <pyglib-python-compat.h>
 
@@ -541,6 +543,235 @@ _wrap_pyg_source_new (PyObject *self, PyObject *args)
     return pyg_source_new ();
 }
 
+static PyGIFunctionCache *
+_get_function_cache (PyObject *py_func)
+{
+    PyGICallableInfo *callable_info;
+
+    if (!PyObject_TypeCheck (py_func, &PyGICallableInfo_Type) ||
+            g_base_info_get_type (((PyGIBaseInfo *) py_func)->info) == GI_INFO_TYPE_CALLBACK) {
+        PyErr_Format (PyExc_TypeError, "expected an introspected function, got %s",
+                      Py_TYPE (py_func)->tp_name);
+        return NULL;
+    }
+
+    callable_info = (PyGICallableInfo *) py_func;
+    if (callable_info->py_unbound_info != NULL)
+        callable_info = (PyGICallableInfo *) callable_info->py_unbound_info;
+
+    return _pygi_callable_info_get_function_cache ((PyGIBaseInfo *) callable_info);
+}
+
+static PyObject *
+_wrap_pyg_set_gil_release (PyObject *self, PyObject *args)
+{
+    PyObject *py_func;
+    PyObject *py_release;
+    PyGIFunctionCache *function_cache;
+    int release;
+
+    if (!PyArg_ParseTuple (args, "OO:set_gil_release", &py_func, &py_release))
+        return NULL;
+
+    release = PyObject_IsTrue (py_release);
+    if (release < 0)
+        return NULL;
+
+    function_cache = _get_function_cache (py_func);
+    if (function_cache == NULL)
+        return NULL;
+
+    function_cache->release_gil = release;
+
+    Py_RETURN_NONE;
+}
+
+static PyObject *
+_wrap_pyg_get_gil_release (PyObject *self, PyObject *py_func)
+{
+    PyGIFunctionCache *function_cache;
+
+    function_cache = _get_function_cache (py_func);
+    if (function_cache == NULL)
+        return NULL;
+
+    return PyBool_FromLong (function_cache->release_gil);
+}
+
+static PyObject *
+_wrap_pyg_set_direct_call (PyObject *self, PyObject *args)
+{
+    PyObject *py_func;
+    PyObject *py_enabled;
+    PyGIFunctionCache *function_cache;
+    int enabled;
+
+    if (!PyArg_ParseTuple (args, "OO:set_direct_call", &py_func, &py_enabled))
+        return NULL;
+
+    enabled = PyObject_IsTrue (py_enabled);
+    if (enabled < 0)
+        return NULL;
+
+    function_cache = _get_function_cache (py_func);
+    if (function_cache == NULL)
+        return NULL;
+
+    if (enabled)
+        function_cache->direct_call = pygi_direct_call_lookup (&function_cache->invoker.cif);
+    else
+        function_cache->direct_call = NULL;
+
+    return PyBool_FromLong (function_cache->direct_call != NULL);
+}
+
+static PyObject *
+_wrap_pyg_invoke_many (PyObject *self, PyObject *args)
+{
+    PyObject *py_func;
+    PyObject *py_iterable;
+    PyGIFunctionCache *function_cache;
+
+    if (!PyArg_ParseTuple (args, "OO:invoke_many", &py_func, &py_iterable))
+        return NULL;
+
+    function_cache = _get_function_cache (py_func);
+    if (function_cache == NULL)
+        return NULL;
+
+    return pygi_invoke_c_callable_many (function_cache,
+                                        ((PyGICallableInfo *) py_func)->py_bound_arg,
+                                        py_iterable);
+}
+
+static PyObject *
+_wrap_pyg_invoke_state_pool_stats (PyObject *self, PyObject *args)
+{
+    gsize hits, misses;
+
+    _pygi_invoke_arg_state_stats (&hits, &misses);
+
+    return Py_BuildValue ("{s:n,s:n}",
+                          "hits", (Py_ssize_t) hits,
+                          "misses", (Py_ssize_t) misses);
+}
+
+static PyObject *
+_wrap_pyg_closure_pool_stats (PyObject *self, PyObject *args)
+{
+    gsize hits, misses, discarded, pooled;
+
+    _pygi_closure_pool_stats (&hits, &misses, &discarded, &pooled);
+
+    return Py_BuildValue ("{s:n,s:n,s:n,s:n}",
+                          "hits", (Py_ssize_t) hits,
+                          "misses", (Py_ssize_t) misses,
+                          "discarded", (Py_ssize_t) discarded,
+                          "pooled", (Py_ssize_t) pooled);
+}
+
+static PyObject *
+_wrap_pyg_profiler_set_enabled (PyObject *self, PyObject *args)
+{
+    PyObject *py_enabled;
+    int enabled;
+
+    if (!PyArg_ParseTuple (args, "O:profiler_set_enabled", &py_enabled))
+        return NULL;
+
+    enabled = PyObject_IsTrue (py_enabled);
+    if (enabled < 0)
+        return NULL;
+
+#ifdef PYGI_DISABLE_PROFILER
+    if (enabled) {
+        PyErr_SetString (PyExc_RuntimeError,
+                         "PyGObject was built with --disable-profiler");
+        return NULL;
+    }
+#endif
+
+    pygi_profiler_enabled = enabled;
+
+    Py_RETURN_NONE;
+}
+
+static PyObject *
+_wrap_pyg_profiler_is_available (PyObject *self, PyObject *args)
+{
+#ifdef PYGI_DISABLE_PROFILER
+    Py_RETURN_FALSE;
+#else
+    Py_RETURN_TRUE;
+#endif
+}
+
+static PyObject *
+_wrap_pyg_profiler_is_enabled (PyObject *self, PyObject *args)
+{
+    return PyBool_FromLong (pygi_profiler_enabled);
+}
+
+static PyObject *
+_wrap_pyg_profiler_reset (PyObject *self, PyObject *args)
+{
+    pygi_profiler_reset ();
+
+    Py_RETURN_NONE;
+}
+
+static PyObject *
+_wrap_pyg_profiler_get_stats (PyObject *self, PyObject *args)
+{
+    return pygi_profiler_to_py ();
+}
+
+static PyObject *
+_wrap_pyg_signal_profiler_set_enabled (PyObject *self, PyObject *args)
+{
+    PyObject *py_enabled;
+    int enabled;
+
+    if (!PyArg_ParseTuple (args, "O:signal_profiler_set_enabled", &py_enabled))
+        return NULL;
+
+    enabled = PyObject_IsTrue (py_enabled);
+    if (enabled < 0)
+        return NULL;
+
+#ifdef PYGI_DISABLE_PROFILER
+    if (enabled) {
+        PyErr_SetString (PyExc_RuntimeError,
+                         "PyGObject was built with --disable-profiler");
+        return NULL;
+    }
+#endif
+
+    pygi_signal_profiler_enabled = enabled;
+
+    Py_RETURN_NONE;
+}
+
+static PyObject *
+_wrap_pyg_signal_profiler_is_enabled (PyObject *self, PyObject *args)
+{
+    return PyBool_FromLong (pygi_signal_profiler_enabled);
+}
+
+static PyObject *
+_wrap_pyg_signal_profiler_reset (PyObject *self, PyObject *args)
+{
+    pygi_signal_profiler_reset ();
+
+    Py_RETURN_NONE;
+}
+
+static PyObject *
+_wrap_pyg_signal_profiler_get_stats (PyObject *self, PyObject *args)
+{
+    return pygi_signal_profiler_to_py ();
+}
+
 #define CHUNK_SIZE 8192
 
 static PyObject*
@@ -627,6 +858,21 @@ static PyMethodDef _gi_functions[] = {
     { "source_set_callback", (PyCFunction) pyg_source_set_callback, METH_VARARGS },
     { "io_channel_read", (PyCFunction) pyg_channel_read, METH_VARARGS },
     { "require_foreign", (PyCFunction) pygi_require_foreign, METH_VARARGS | METH_KEYWORDS },
+    { "set_gil_release", (PyCFunction) _wrap_pyg_set_gil_release, METH_VARARGS },
+    { "get_gil_release", (PyCFunction) _wrap_pyg_get_gil_release, METH_O },
+    { "set_direct_call", (PyCFunction) _wrap_pyg_set_direct_call, METH_VARARGS },
+    { "invoke_many", (PyCFunction) _wrap_pyg_invoke_many, METH_VARARGS },
+    { "invoke_state_pool_stats", (PyCFunction) _wrap_pyg_invoke_state_pool_stats, METH_NOARGS },
+    { "closure_pool_stats", (PyCFunction) _wrap_pyg_closure_pool_stats, METH_NOARGS },
+    { "profiler_is_available", (PyCFunction) _wrap_pyg_profiler_is_available, METH_NOARGS },
+    { "profiler_set_enabled", (PyCFunction) _wrap_pyg_profiler_set_enabled, METH_VARARGS },
+    { "profiler_is_enabled", (PyCFunction) _wrap_pyg_profiler_is_enabled, METH_NOARGS },
+    { "profiler_reset", (PyCFunction) _wrap_pyg_profiler_reset, METH_NOARGS },
+    { "profiler_get_stats", (PyCFunction) _wrap_pyg_profiler_get_stats, METH_NOARGS },
+    { "signal_profiler_set_enabled", (PyCFunction) _wrap_pyg_signal_profiler_set_enabled, METH_VARARGS },
+    { "signal_profiler_is_enabled", (PyCFunction) _wrap_pyg_signal_profiler_is_enabled, METH_NOARGS },
+    { "signal_profiler_reset", (PyCFunction) _wrap_pyg_signal_profiler_reset, METH_NOARGS },
+    { "signal_profiler_get_stats", (PyCFunction) _wrap_pyg_signal_profiler_get_stats, METH_NOARGS },
     { NULL, NULL, 0 }
 };
 
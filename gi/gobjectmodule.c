@@ -849,6 +849,7 @@ pyg_object_class_init(GObjectClass *class, PyObject *py_class)
 	if (!add_properties(class, gproperties)) {
 	    return;
 	}
+	pygobject_props_cache_invalidate();
 	PyDict_DelItemString(class_dict, "__gproperties__");
 	/* Borrowed reference. Py_DECREF(gproperties); */
     } else {
@@ -1345,7 +1346,7 @@ pyg_object_new (PyGObject *self, PyObject *args, PyObject *kwargs)
     GType type;
     GObject *obj = NULL;
     GObjectClass *class;
-    guint n_params = 0, i;
+    guint n_params = 0;
     GParameter *params = NULL;
 
     if (!PyArg_ParseTuple (args, "O:gobject.new", &pytype)) {
@@ -1375,11 +1376,7 @@ pyg_object_new (PyGObject *self, PyObject *args, PyObject *kwargs)
 	PyErr_SetString (PyExc_RuntimeError, "could not create object");
 
  cleanup:
-    for (i = 0; i < n_params; i++) {
-	g_free((gchar *) params[i].name);
-	g_value_unset(&params[i].value);
-    }
-    g_free(params);
+    pygobject_free_construct_properties (n_params, params);
     g_type_class_unref(class);
 
     if (obj) {
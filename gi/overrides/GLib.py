@@ -22,6 +22,8 @@
 import signal
 import warnings
 import sys
+import threading
+from collections import deque
 
 from ..module import get_introspection_module
 from .._gi import (variant_type_from_string, source_new,
@@ -672,6 +674,127 @@ def idle_add(function, *user_data, **kwargs):
 __all__.append('idle_add')
 
 
+class _IdleBatch(object):
+    """Callbacks added with idle_add_batched() for one priority, all run by
+    one idle source."""
+
+    def __init__(self, priority):
+        self.priority = priority
+        self.lock = threading.Lock()
+        self.pending = deque()
+        self.source_id = 0
+
+    def add(self, handle):
+        with self.lock:
+            self.pending.append(handle)
+            if not self.source_id:
+                self.source_id = GLib.idle_add(self.priority, self.dispatch)
+
+    def dispatch(self):
+        # callbacks added meanwhile or asking to be called again run in the
+        # next iteration, so other sources of the same priority get a chance
+        with self.lock:
+            batch = self.pending
+            self.pending = deque()
+
+        keep = True
+        completed = False
+        try:
+            for i in range(len(batch)):
+                handle = batch.popleft()
+                function, user_data = handle._function, handle._user_data
+                if handle._batch is not self or function is None:
+                    continue
+
+                try:
+                    again = function(*user_data)
+                except Exception:
+                    sys.excepthook(*sys.exc_info())
+                    again = False
+
+                if again:
+                    batch.append(handle)
+                else:
+                    handle.remove()
+            completed = True
+        finally:
+            with self.lock:
+                batch.extend(self.pending)
+                self.pending = batch
+                if not batch:
+                    self.source_id = 0
+                    keep = False
+                elif not completed:
+                    # escaping exceptions remove the idle source, so the
+                    # remaining callbacks need a new one
+                    self.source_id = GLib.idle_add(self.priority, self.dispatch)
+
+        return keep
+
+
+class IdleBatchHandle(object):
+    """Returned by :func:`idle_add_batched`, can be passed to
+    :func:`source_remove`."""
+
+    __slots__ = ('_batch', '_function', '_user_data')
+
+    def __init__(self, batch, function, user_data):
+        self._batch = batch
+        self._function = function
+        self._user_data = user_data
+
+    def remove(self):
+        """Removes the callback, returns False if it was removed already."""
+        if self._batch is None:
+            return False
+        self._batch = None
+        self._function = None
+        self._user_data = None
+        return True
+
+
+_idle_batches = {}
+_idle_batches_lock = threading.Lock()
+
+
+def idle_add_batched(function, *user_data, **kwargs):
+    """idle_add_batched(function, *user_data, priority=GLib.PRIORITY_DEFAULT_IDLE) -> handle
+
+    Like :func:`idle_add`, but all callbacks of the same priority are run by
+    a single idle source of the default main context, one after another and
+    in the order they were added, with only one GIL acquisition per main
+    loop iteration. Callbacks returning True get called again in the next
+    iteration.
+
+    This is meant for adding lots of short callbacks, for example from
+    worker threads passing their results to the main thread. The returned
+    handle can be passed to :func:`source_remove` but not to the other
+    functions taking source IDs.
+    """
+    if not callable(function):
+        raise TypeError('first argument must be callable')
+
+    priority = kwargs.get('priority', GLib.PRIORITY_DEFAULT_IDLE)
+    with _idle_batches_lock:
+        batch = _idle_batches.get(priority)
+        if batch is None:
+            batch = _idle_batches[priority] = _IdleBatch(priority)
+
+    handle = IdleBatchHandle(batch, function, user_data)
+    batch.add(handle)
+    return handle
+
+__all__ += ['IdleBatchHandle', 'idle_add_batched']
+
+
+def source_remove(tag):
+    if isinstance(tag, IdleBatchHandle):
+        return tag.remove()
+    return GLib.source_remove(tag)
+
+__all__.append('source_remove')
+
+
 def timeout_add(interval, function, *user_data, **kwargs):
     priority = kwargs.get('priority', GLib.PRIORITY_DEFAULT)
     return GLib.timeout_add(priority, interval, function, *user_data)
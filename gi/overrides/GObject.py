@@ -209,6 +209,46 @@ __all__ += ['features', 'list_properties', 'new',
             'pygobject_version', 'threads_init', 'type_register']
 
 
+GPropertyDescriptor = _gobject.GPropertyDescriptor
+
+
+def install_property_descriptors(cls, names=None):
+    """Makes GObject properties accessible as attributes of the instances
+    of cls, e.g. ``label.label`` in addition to ``label.props.label``.
+
+    :param cls: GObject class, also usable as class decorator
+    :param names:
+        names of the properties, by default all properties of cls are
+        installed which don't clash with an existing attribute and are not
+        implemented in Python
+    :returns: cls
+    :raises:
+        AttributeError if a property doesn't exist, TypeError if it is
+        implemented in Python
+
+    The attributes are :class:`GPropertyDescriptor` instances which keep
+    the GParamSpec of their property, so accessing them skips the creation
+    of the props object and the property lookup.
+    """
+    if names is None:
+        for pspec in cls.props:
+            name = pspec.name.replace('-', '_')
+            if hasattr(cls, name):
+                continue
+            try:
+                setattr(cls, name, GPropertyDescriptor(pspec))
+            except TypeError:
+                pass
+    else:
+        for name in names:
+            pspec = getattr(cls.props, name.replace('-', '_'))
+            setattr(cls, pspec.name.replace('-', '_'), GPropertyDescriptor(pspec))
+
+    return cls
+
+__all__ += ['GPropertyDescriptor', 'install_property_descriptors']
+
+
 class Value(GObjectModule.Value):
     def __init__(self, value_type=None, py_value=None):
         GObjectModule.Value.__init__(self)
@@ -0,0 +1,212 @@
+# -*- Mode: Python; py-indent-offset: 4 -*-
+# vim: tabstop=4 shiftwidth=4 expandtab
+#
+#   profiler.py: per callable invocation statistics
+#
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License as published by the Free Software Foundation; either
+# version 2.1 of the License, or (at your option) any later version.
+#
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this library; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301
+# USA
+
+"""Records how often introspected callables get called and where the time
+of the calls is spent.
+
+The profiler is disabled by default, it can be enabled with :func:`enable`
+or by setting the ``PYGI_PROFILE`` environment variable to ``1``, in which
+case a report is written to stderr on exit.
+
+Calls of Python signal handlers and signal emissions from Python are
+recorded separately, see :func:`enable_signals`.
+"""
+
+from __future__ import absolute_import
+
+import sys
+from collections import namedtuple
+
+from . import _gi
+
+
+class CallStats(namedtuple('CallStats', ['calls', 'closure_calls',
+                                           'in_marshal', 'ffi_call',
+                                           'out_marshal', 'cleanup'])):
+    """Statistics of a callable, times are in seconds.
+
+    calls: number of calls from Python
+    closure_calls: number of calls of Python callbacks of this callback type
+    in_marshal: time spent converting the arguments to C
+    ffi_call: time spent in the C function
+    out_marshal: time spent converting the results to Python
+    cleanup: time spent freeing the arguments
+    """
+
+    __slots__ = ()
+
+    @property
+    def total(self):
+        return self.in_marshal + self.ffi_call + self.out_marshal + self.cleanup
+
+
+class SignalStats(namedtuple('SignalStats', ['calls', 'exceptions',
+                                               'total', 'max'])):
+    """Statistics of a signal handler, times are in seconds.
+
+    calls: number of calls
+    exceptions: number of calls which raised an exception
+    total: time spent in all calls
+    max: time spent in the slowest call
+    """
+
+    __slots__ = ()
+
+
+def is_available():
+    """Returns False if PyGObject was built with ``--disable-profiler``,
+    in which case enabling the profiler raises RuntimeError."""
+    return _gi.profiler_is_available()
+
+
+def enable():
+    """Start recording statistics."""
+    _gi.profiler_set_enabled(True)
+
+
+def disable():
+    """Stop recording statistics, the recorded ones are kept."""
+    _gi.profiler_set_enabled(False)
+
+
+def is_enabled():
+    return _gi.profiler_is_enabled()
+
+
+def reset():
+    """Discard all recorded statistics."""
+    _gi.profiler_reset()
+
+
+def get_stats():
+    """Returns a dict mapping the full names of the called callables
+    (e.g. ``'Gtk.Widget.show'``) to :class:`CallStats`.
+    """
+    stats = {}
+    for name, values in _gi.profiler_get_stats().items():
+        calls, closure_calls = values[:2]
+        times = [t / 1e9 for t in values[2:]]
+        stats[name] = CallStats(calls, closure_calls, *times)
+    return stats
+
+
+_sort_keys = {
+    'total': lambda s: s.total,
+    'calls': lambda s: s.calls + s.closure_calls,
+    'in_marshal': lambda s: s.in_marshal,
+    'ffi_call': lambda s: s.ffi_call,
+    'out_marshal': lambda s: s.out_marshal,
+    'cleanup': lambda s: s.cleanup,
+}
+
+
+def dump(file=None, sort='total', limit=None):
+    """Write a report of the recorded statistics.
+
+    :param file: file to write to, defaults to sys.stderr
+    :param str sort:
+        one of 'total', 'calls', 'in_marshal', 'ffi_call', 'out_marshal'
+        or 'cleanup', the most expensive callables come first
+    :param limit: maximum number of callables to list or None for all
+    """
+    if file is None:
+        file = sys.stderr
+
+    key = _sort_keys[sort]
+    items = sorted(get_stats().items(), key=lambda i: (-key(i[1]), i[0]))
+    if limit is not None:
+        items = items[:limit]
+
+    file.write('%10s %10s %12s %12s %12s %12s %12s  %s\n' % (
+        'calls', 'closures', 'total(ms)', 'in(ms)', 'ffi(ms)', 'out(ms)',
+        'cleanup(ms)', 'callable'))
+    for name, s in items:
+        file.write('%10d %10d %12.3f %12.3f %12.3f %12.3f %12.3f  %s\n' % (
+            s.calls, s.closure_calls, s.total * 1e3, s.in_marshal * 1e3,
+            s.ffi_call * 1e3, s.out_marshal * 1e3, s.cleanup * 1e3, name))
+
+
+def enable_signals():
+    """Start recording statistics of signal handlers."""
+    _gi.signal_profiler_set_enabled(True)
+
+
+def disable_signals():
+    """Stop recording statistics of signal handlers, the recorded ones are
+    kept."""
+    _gi.signal_profiler_set_enabled(False)
+
+
+def signals_enabled():
+    return _gi.signal_profiler_is_enabled()
+
+
+def reset_signals():
+    """Discard all recorded statistics of signal handlers."""
+    _gi.signal_profiler_reset()
+
+
+def get_signal_stats():
+    """Returns a dict mapping tuples of (type name, signal name, handler)
+    to :class:`SignalStats`.
+
+    The handler is the module and qualified name of the Python handler
+    (e.g. ``'app.Window.on_clicked'``) or None for the emissions with
+    :meth:`GObject.Object.emit`, which include the C handlers.
+    """
+    stats = {}
+    for key, values in _gi.signal_profiler_get_stats().items():
+        calls, exceptions, total, max_ = values
+        stats[key] = SignalStats(calls, exceptions, total / 1e9, max_ / 1e9)
+    return stats
+
+
+_signal_sort_keys = {
+    'total': lambda s: s.total,
+    'max': lambda s: s.max,
+    'calls': lambda s: s.calls,
+    'exceptions': lambda s: s.exceptions,
+}
+
+
+def dump_signals(file=None, sort='total', limit=None):
+    """Write a report of the recorded signal handler statistics.
+
+    :param file: file to write to, defaults to sys.stderr
+    :param str sort:
+        one of 'total', 'max', 'calls' or 'exceptions', the most expensive
+        handlers come first
+    :param limit: maximum number of handlers to list or None for all
+    """
+    if file is None:
+        file = sys.stderr
+
+    key = _signal_sort_keys[sort]
+    items = sorted(get_signal_stats().items(),
+                   key=lambda i: (-key(i[1]), i[0][0], i[0][1], i[0][2] or ''))
+    if limit is not None:
+        items = items[:limit]
+
+    file.write('%10s %10s %12s %12s  %s\n' % (
+        'calls', 'exceptions', 'total(ms)', 'max(ms)', 'signal: handler'))
+    for (type_name, signal_name, handler), s in items:
+        file.write('%10d %10d %12.3f %12.3f  %s::%s: %s\n' % (
+            s.calls, s.exceptions, s.total * 1e3, s.max * 1e3,
+            type_name, signal_name, handler or '<emission>'))
@@ -19,6 +19,8 @@
  * License along with this library; if not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <string.h>
+
 #include "pygi-boxed.h"
 #include "pygi-info.h"
 #include "pygboxed.h"
@@ -27,6 +29,82 @@
 #include <girepository.h>
 #include <pyglib-python-compat.h>
 
+/* Memory of boxed instances created from Python and of caller allocated out
+ * arguments is usually short lived, e.g. a Gdk.RGBA or Gtk.TreeIter which
+ * gets discarded right after reading its fields. Keep freed blocks around
+ * in per size free lists so they can be reused without going through the
+ * allocator. Only used with the GIL held.
+ */
+#define PYGI_BOXED_POOL_ALIGN        16
+#define PYGI_BOXED_POOL_N_BUCKETS    16   /* blocks up to 256 bytes */
+#define PYGI_BOXED_POOL_MAX_BLOCKS   32   /* per bucket */
+
+#define PYGI_BOXED_POOL_BUCKET(size) (((size) + PYGI_BOXED_POOL_ALIGN - 1) / PYGI_BOXED_POOL_ALIGN - 1)
+#define PYGI_BOXED_POOL_BLOCK_SIZE(bucket) (((bucket) + 1) * PYGI_BOXED_POOL_ALIGN)
+
+typedef struct _PyGIBoxedPoolBlock PyGIBoxedPoolBlock;
+struct _PyGIBoxedPoolBlock {
+    PyGIBoxedPoolBlock *next;
+};
+
+static struct {
+    PyGIBoxedPoolBlock *free_list;
+    guint n_blocks;
+} boxed_pool[PYGI_BOXED_POOL_N_BUCKETS];
+
+/**
+ * _pygi_boxed_slice_alloc0:
+ * @size: size of the memory block
+ *
+ * Allocates zeroed memory for a boxed instance, to be freed with
+ * _pygi_boxed_slice_free() passing the same size.
+ */
+gpointer
+_pygi_boxed_slice_alloc0 (gsize size)
+{
+    gsize bucket;
+    PyGIBoxedPoolBlock *block;
+
+    if (size == 0 || (bucket = PYGI_BOXED_POOL_BUCKET (size)) >= PYGI_BOXED_POOL_N_BUCKETS)
+        return g_slice_alloc0 (size);
+
+    block = boxed_pool[bucket].free_list;
+    if (block == NULL)
+        return g_slice_alloc0 (PYGI_BOXED_POOL_BLOCK_SIZE (bucket));
+
+    boxed_pool[bucket].free_list = block->next;
+    boxed_pool[bucket].n_blocks--;
+    memset (block, 0, PYGI_BOXED_POOL_BLOCK_SIZE (bucket));
+
+    return block;
+}
+
+/**
+ * _pygi_boxed_slice_free:
+ * @size: size passed to _pygi_boxed_slice_alloc0()
+ * @mem: memory to free
+ */
+void
+_pygi_boxed_slice_free (gsize size, gpointer mem)
+{
+    gsize bucket;
+    PyGIBoxedPoolBlock *block = mem;
+
+    if (size == 0 || (bucket = PYGI_BOXED_POOL_BUCKET (size)) >= PYGI_BOXED_POOL_N_BUCKETS) {
+        g_slice_free1 (size, mem);
+        return;
+    }
+
+    if (boxed_pool[bucket].n_blocks >= PYGI_BOXED_POOL_MAX_BLOCKS) {
+        g_slice_free1 (PYGI_BOXED_POOL_BLOCK_SIZE (bucket), mem);
+        return;
+    }
+
+    block->next = boxed_pool[bucket].free_list;
+    boxed_pool[bucket].free_list = block;
+    boxed_pool[bucket].n_blocks++;
+}
+
 static void
 _boxed_dealloc (PyGIBoxed *self)
 {
@@ -41,7 +119,7 @@ boxed_del (PyGIBoxed *self)
 
     if ( ( (PyGBoxed *) self)->free_on_dealloc && boxed != NULL) {
         if (self->slice_allocated) {
-            g_slice_free1 (self->size, boxed);
+            _pygi_boxed_slice_free (self->size, boxed);
         } else {
             g_type = pyg_type_from_object ( (PyObject *) self);
             g_boxed_free (g_type, boxed);
@@ -84,7 +162,7 @@ _pygi_boxed_alloc (GIBaseInfo *info, gsize *size_out)
     if( size_out != NULL)
         *size_out = size;
 
-    boxed = g_slice_alloc0 (size);
+    boxed = _pygi_boxed_slice_alloc0 (size);
     if (boxed == NULL)
         PyErr_NoMemory();
     return boxed;
@@ -115,7 +193,7 @@ _boxed_new (PyTypeObject *type,
 
     self = (PyGIBoxed *) _pygi_boxed_new (type, boxed, FALSE, size);
     if (self == NULL) {
-        g_slice_free1 (size, boxed);
+        _pygi_boxed_slice_free (size, boxed);
         goto out;
     }
 
@@ -226,6 +304,7 @@ _pygi_boxed_copy_in_place (PyGIBoxed *self)
     boxed_del (self);
     pyg_boxed_set_ptr (pygboxed, copy);
     pygboxed->free_on_dealloc = TRUE;
+    self->slice_allocated = FALSE;
 }
 
 static PyGetSetDef pygi_boxed_getsets[] = {
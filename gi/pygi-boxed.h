@@ -42,6 +42,10 @@ PyObject * _pygi_boxed_new (PyTypeObject *pytype,
 void * _pygi_boxed_alloc (GIBaseInfo *info,
                           gsize *size);
 
+gpointer _pygi_boxed_slice_alloc0 (gsize size);
+
+void _pygi_boxed_slice_free (gsize size, gpointer mem);
+
 void _pygi_boxed_copy_in_place  (PyGIBoxed *self);
 
 void _pygi_boxed_register_types (PyObject *m);
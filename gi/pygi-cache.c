@@ -457,6 +457,137 @@ _pygi_get_direction (PyGICallableCache *callable_cache, GIDirection gi_direction
     }
 }
 
+static void
+_callable_cache_clear_arg_names (PyGICallableCache *callable_cache)
+{
+    gssize i;
+
+    for (i = 0; i < callable_cache->n_arg_names; i++)
+        Py_XDECREF (callable_cache->arg_names[i].py_name);
+
+    g_free (callable_cache->arg_names);
+    callable_cache->arg_names = NULL;
+    callable_cache->n_arg_names = 0;
+}
+
+/* _callable_cache_set_arg_names:
+ * @arg_name_list: args_cache indices of the arguments passed from Python
+ *
+ * Interns the argument names so keyword arguments can be matched by
+ * identity when invoking.
+ */
+static gboolean
+_callable_cache_set_arg_names (PyGICallableCache *callable_cache,
+                               GSList *arg_name_list)
+{
+    GSList *l;
+    gssize i;
+
+    callable_cache->n_arg_names = g_slist_length (arg_name_list);
+    callable_cache->arg_names = g_new0 (PyGIArgName, callable_cache->n_arg_names);
+
+    for (i = 0, l = arg_name_list; l != NULL; i++, l = l->next) {
+        gssize arg_index = GPOINTER_TO_INT (l->data);
+        PyGIArgCache *arg_cache = _pygi_callable_cache_get_arg (callable_cache, arg_index);
+        PyGIArgName *arg_name = &callable_cache->arg_names[i];
+
+        arg_name->name = arg_cache->arg_name;
+        arg_name->arg_index = -1;
+
+        if (arg_cache->arg_name != NULL) {
+            arg_name->py_name = PYGLIB_PyUnicode_InternFromString (arg_cache->arg_name);
+            if (arg_name->py_name == NULL)
+                return FALSE;
+            arg_name->arg_index = arg_index;
+        }
+    }
+
+    return TRUE;
+}
+
+static gboolean
+_type_tag_is_scalar (GITypeTag type_tag)
+{
+    switch (type_tag) {
+        case GI_TYPE_TAG_BOOLEAN:
+        case GI_TYPE_TAG_INT8:
+        case GI_TYPE_TAG_UINT8:
+        case GI_TYPE_TAG_INT16:
+        case GI_TYPE_TAG_UINT16:
+        case GI_TYPE_TAG_INT32:
+        case GI_TYPE_TAG_UINT32:
+        case GI_TYPE_TAG_INT64:
+        case GI_TYPE_TAG_UINT64:
+        case GI_TYPE_TAG_FLOAT:
+        case GI_TYPE_TAG_DOUBLE:
+            return TRUE;
+        default:
+            return FALSE;
+    }
+}
+
+static void
+_marshal_step_init_to_py (PyGIMarshalStep *step, PyGIArgCache *arg_cache)
+{
+    step->op = PYGI_MARSHAL_OP_GENERIC;
+    step->type_tag = arg_cache->type_tag;
+    step->transfer = arg_cache->transfer;
+    step->index = arg_cache->c_arg_index;
+    step->arg_cache = arg_cache;
+
+    if (arg_cache->to_py_marshaller == _pygi_marshal_to_py_basic_type_cache_adapter &&
+            arg_cache->to_py_cleanup == NULL &&
+            _type_tag_is_scalar (arg_cache->type_tag))
+        step->op = PYGI_MARSHAL_OP_TO_PY_BASIC;
+}
+
+/* _callable_cache_compile_marshal_plan:
+ *
+ * Flattens the argument caches into arrays of PyGIMarshalStep which are
+ * interpreted when invoking, see _invoke_marshal_in_args().
+ */
+static void
+_callable_cache_compile_marshal_plan (PyGICallableCache *callable_cache)
+{
+    guint i, n_args = _pygi_callable_cache_args_len (callable_cache);
+    GSList *l;
+
+    g_free (callable_cache->in_plan);
+    g_free (callable_cache->to_py_plan);
+
+    callable_cache->in_plan = g_new0 (PyGIMarshalStep, n_args);
+    for (i = 0; i < n_args; i++) {
+        PyGIArgCache *arg_cache = _pygi_callable_cache_get_arg (callable_cache, i);
+        PyGIMarshalStep *step = &callable_cache->in_plan[i];
+
+        step->op = PYGI_MARSHAL_OP_GENERIC;
+        step->type_tag = arg_cache->type_tag;
+        step->transfer = arg_cache->transfer;
+        step->index = arg_cache->py_arg_index;
+        step->arg_cache = arg_cache;
+
+        if (arg_cache->direction == PYGI_DIRECTION_FROM_PYTHON) {
+            if (arg_cache->meta_type == PYGI_META_ARG_TYPE_CLOSURE)
+                step->op = PYGI_MARSHAL_OP_IN_CLOSURE;
+            else if (arg_cache->meta_type != PYGI_META_ARG_TYPE_PARENT)
+                step->op = PYGI_MARSHAL_OP_IN_CHILD;
+            else if (arg_cache->from_py_marshaller == _pygi_marshal_from_py_basic_type_cache_adapter &&
+                     arg_cache->from_py_cleanup == NULL &&
+                     _type_tag_is_scalar (arg_cache->type_tag))
+                step->op = PYGI_MARSHAL_OP_IN_BASIC;
+        } else if (arg_cache->direction == PYGI_DIRECTION_TO_PYTHON &&
+                   !arg_cache->is_caller_allocates) {
+            step->op = PYGI_MARSHAL_OP_OUT;
+        }
+    }
+
+    callable_cache->to_py_plan = g_new0 (PyGIMarshalStep, g_slist_length (callable_cache->to_py_args));
+    for (i = 0, l = callable_cache->to_py_args; l != NULL; i++, l = l->next)
+        _marshal_step_init_to_py (&callable_cache->to_py_plan[i], l->data);
+
+    _marshal_step_init_to_py (&callable_cache->return_step, callable_cache->return_cache);
+}
+
 /* Generate the cache for the callable's arguments */
 static gboolean
 _callable_cache_generate_args_cache_real (PyGICallableCache *callable_cache,
@@ -471,6 +602,7 @@ _callable_cache_generate_args_cache_real (PyGICallableCache *callable_cache,
 	gssize last_explicit_arg_index;
     PyObject *tuple_names;
     GSList *arg_cache_item;
+    GSList *arg_name_list = NULL;
     PyTypeObject* resulttuple_type;
 
     /* Return arguments are always considered out */
@@ -595,17 +727,13 @@ _callable_cache_generate_args_cache_real (PyGICallableCache *callable_cache,
 
     }
 
-    if (callable_cache->arg_name_hash == NULL) {
-        callable_cache->arg_name_hash = g_hash_table_new (g_str_hash, g_str_equal);
-    } else {
-        g_hash_table_remove_all (callable_cache->arg_name_hash);
-    }
+    _callable_cache_clear_arg_names (callable_cache);
     callable_cache->n_py_required_args = 0;
     callable_cache->user_data_varargs_index = -1;
 
     last_explicit_arg_index = -1;
 
-    /* Reverse loop through all the arguments to setup arg_name_list/hash
+    /* Reverse loop through all the arguments to setup arg_name_list
      * and find the number of required arguments */
     for (i=((gssize)_pygi_callable_cache_args_len (callable_cache))-1; i >= 0; i--) {
         PyGIArgCache *arg_cache = _pygi_callable_cache_get_arg (callable_cache, i);
@@ -614,15 +742,8 @@ _callable_cache_generate_args_cache_real (PyGICallableCache *callable_cache,
                 arg_cache->meta_type != PYGI_META_ARG_TYPE_CLOSURE &&
                 arg_cache->direction & PYGI_DIRECTION_FROM_PYTHON) {
 
-            /* Setup arg_name_list and arg_name_hash */
-            gpointer arg_name = (gpointer)arg_cache->arg_name;
-            callable_cache->arg_name_list = g_slist_prepend (callable_cache->arg_name_list,
-                                                             arg_name);
-            if (arg_name != NULL) {
-                g_hash_table_insert (callable_cache->arg_name_hash,
-                                     arg_name,
-                                     GINT_TO_POINTER(i));
-            }
+            /* Setup arg_name_list */
+            arg_name_list = g_slist_prepend (arg_name_list, GINT_TO_POINTER (i));
 
             /* The first tail argument without a default will force all the preceding
              * argument defaults off. This limits support of default args to the
@@ -648,10 +769,18 @@ _callable_cache_generate_args_cache_real (PyGICallableCache *callable_cache,
         }
     }
 
+    if (!_callable_cache_set_arg_names (callable_cache, arg_name_list)) {
+        g_slist_free (arg_name_list);
+        return FALSE;
+    }
+    g_slist_free (arg_name_list);
+
     if (!return_cache->is_skipped && return_cache->type_tag != GI_TYPE_TAG_VOID) {
         callable_cache->has_return = TRUE;
     }
 
+    _callable_cache_compile_marshal_plan (callable_cache);
+
     tuple_names = PyList_New (0);
     if (callable_cache->has_return) {
         PyList_Append (tuple_names, Py_None);
@@ -685,8 +814,9 @@ static void
 _callable_cache_deinit_real (PyGICallableCache *cache)
 {
     g_slist_free (cache->to_py_args);
-    g_slist_free (cache->arg_name_list);
-    g_hash_table_destroy (cache->arg_name_hash);
+    _callable_cache_clear_arg_names (cache);
+    g_free (cache->in_plan);
+    g_free (cache->to_py_plan);
     g_ptr_array_unref (cache->args_cache);
     Py_XDECREF (cache->resulttuple_type);
 
@@ -765,6 +895,18 @@ pygi_callable_cache_get_full_name (PyGICallableCache *cache)
     }
 }
 
+PyGIProfileStats *
+pygi_callable_cache_get_profile_stats (PyGICallableCache *cache)
+{
+    if (cache->profile_stats == NULL) {
+        gchar *full_name = pygi_callable_cache_get_full_name (cache);
+        cache->profile_stats = pygi_profiler_lookup (full_name);
+        g_free (full_name);
+    }
+
+    return cache->profile_stats;
+}
+
 void
 pygi_callable_cache_free (PyGICallableCache *cache)
 {
@@ -777,11 +919,23 @@ pygi_callable_cache_free (PyGICallableCache *cache)
 static PyObject *
 _function_cache_invoke_real (PyGIFunctionCache *function_cache,
                              PyGIInvokeState *state,
-                             PyObject *py_args,
-                             PyObject *py_kwargs)
+                             PyObject *const *py_args,
+                             Py_ssize_t py_nargs,
+                             PyObject *py_kwnames)
 {
     return pygi_invoke_c_callable (function_cache, state,
-                                   py_args, py_kwargs);
+                                   py_args, py_nargs, py_kwnames);
+}
+
+/* pygi_function_cache_invokes_directly:
+ *
+ * Returns: TRUE if invoking only requires pygi_invoke_c_callable() without
+ *     any extra handling of the arguments (like for constructors and vfuncs).
+ */
+gboolean
+pygi_function_cache_invokes_directly (PyGIFunctionCache *function_cache)
+{
+    return function_cache->invoke == _function_cache_invoke_real;
 }
 
 static void
@@ -792,6 +946,50 @@ _function_cache_deinit_real (PyGICallableCache *callable_cache)
     _callable_cache_deinit_real (callable_cache);
 }
 
+/* _function_cache_should_release_gil:
+ *
+ * Releasing the GIL costs more than calling simple getters and makes threads
+ * contend for it. Keep it for functions named like getters which take and
+ * return only basic types. Everything else, including anything which can
+ * throw, might block and releases the GIL.
+ */
+static gboolean
+_function_cache_should_release_gil (PyGICallableCache *callable_cache,
+                                    GICallableInfo *callable_info)
+{
+    const gchar *name;
+    guint i;
+
+    if (g_base_info_get_type ((GIBaseInfo *) callable_info) != GI_INFO_TYPE_FUNCTION)
+        return TRUE;
+
+    if (callable_cache->throws)
+        return TRUE;
+
+    name = g_base_info_get_name ((GIBaseInfo *) callable_info);
+    if (!g_str_has_prefix (name, "get_") &&
+            !g_str_has_prefix (name, "is_") &&
+            !g_str_has_prefix (name, "has_"))
+        return TRUE;
+
+    if (callable_cache->return_cache == NULL ||
+            !G_TYPE_TAG_IS_BASIC (callable_cache->return_cache->type_tag) ||
+            callable_cache->return_cache->type_tag == GI_TYPE_TAG_VOID)
+        return TRUE;
+
+    /* The instance argument (if any) is fine, others must be basic "in" args */
+    for (i = callable_cache->args_offset; i < _pygi_callable_cache_args_len (callable_cache); i++) {
+        PyGIArgCache *arg_cache = _pygi_callable_cache_get_arg (callable_cache, i);
+
+        if (arg_cache->direction != PYGI_DIRECTION_FROM_PYTHON ||
+                arg_cache->meta_type != PYGI_META_ARG_TYPE_PARENT ||
+                !G_TYPE_TAG_IS_BASIC (arg_cache->type_tag))
+            return TRUE;
+    }
+
+    return FALSE;
+}
+
 static gboolean
 _function_cache_init (PyGIFunctionCache *function_cache,
                       GICallableInfo *callable_info)
@@ -811,11 +1009,16 @@ _function_cache_init (PyGIFunctionCache *function_cache,
     if (!_callable_cache_init (callable_cache, callable_info))
         return FALSE;
 
+    function_cache->release_gil =
+        invoker->native_address != NULL ||
+        _function_cache_should_release_gil (callable_cache, callable_info);
+
     /* Set by PyGICCallbackCache and PyGIVFuncCache */
     if (invoker->native_address == NULL) {
         if (g_function_info_prep_invoker ((GIFunctionInfo *) callable_info,
                                           invoker,
                                           &error)) {
+            function_cache->direct_call = pygi_direct_call_lookup (&invoker->cif);
             return TRUE;
         }
     } else {
@@ -823,6 +1026,7 @@ _function_cache_init (PyGIFunctionCache *function_cache,
                                                 (GIFunctionInfo *) callable_info,
                                                 invoker,
                                                 &error)) {
+            function_cache->direct_call = pygi_direct_call_lookup (&invoker->cif);
             return TRUE;
         }
     }
@@ -854,13 +1058,14 @@ pygi_function_cache_new (GICallableInfo *info)
 
 PyObject *
 pygi_function_cache_invoke (PyGIFunctionCache *function_cache,
-                            PyObject *py_args,
-                            PyObject *py_kwargs)
+                            PyObject *const *py_args,
+                            Py_ssize_t py_nargs,
+                            PyObject *py_kwnames)
 {
     PyGIInvokeState state = { 0, };
 
     return function_cache->invoke (function_cache, &state,
-                                   py_args, py_kwargs);
+                                   py_args, py_nargs, py_kwnames);
 }
 
 /* PyGICCallbackCache */
@@ -887,8 +1092,9 @@ pygi_ccallback_cache_new (GICallableInfo *info,
 
 PyObject *
 pygi_ccallback_cache_invoke (PyGICCallbackCache *ccallback_cache,
-                             PyObject *py_args,
-                             PyObject *py_kwargs,
+                             PyObject *const *py_args,
+                             Py_ssize_t py_nargs,
+                             PyObject *py_kwnames,
                              gpointer user_data)
 {
     PyGIFunctionCache *function_cache = (PyGIFunctionCache *) ccallback_cache;
@@ -897,7 +1103,7 @@ pygi_ccallback_cache_invoke (PyGICCallbackCache *ccallback_cache,
     state.user_data = user_data;
 
     return function_cache->invoke (function_cache, &state,
-                                   py_args, py_kwargs);
+                                   py_args, py_nargs, py_kwnames);
 }
 
 /* PyGIConstructorCache */
@@ -905,17 +1111,15 @@ pygi_ccallback_cache_invoke (PyGICCallbackCache *ccallback_cache,
 static PyObject *
 _constructor_cache_invoke_real (PyGIFunctionCache *function_cache,
                                 PyGIInvokeState *state,
-                                PyObject *py_args,
-                                PyObject *py_kwargs)
+                                PyObject *const *py_args,
+                                Py_ssize_t py_nargs,
+                                PyObject *py_kwnames)
 {
     PyGICallableCache *cache = (PyGICallableCache *) function_cache;
-    PyObject *constructor_class;
     PyObject *ret;
 
-    constructor_class = PyTuple_GetItem (py_args, 0);
-    if (constructor_class == NULL) {
+    if (py_nargs < 1) {
         gchar *full_name = pygi_callable_cache_get_full_name (cache);
-        PyErr_Clear ();
         PyErr_Format (PyExc_TypeError,
                       "Constructors require the class to be passed in as an argument, "
                       "No arguments passed to the %s constructor.",
@@ -925,10 +1129,9 @@ _constructor_cache_invoke_real (PyGIFunctionCache *function_cache,
         return FALSE;
     }
 
-    py_args = PyTuple_GetSlice (py_args, 1, PyTuple_Size (py_args));
+    /* Skip the constructor class, it is not passed on to C. */
     ret = _function_cache_invoke_real (function_cache, state,
-                                       py_args, py_kwargs);
-    Py_DECREF (py_args);
+                                       py_args + 1, py_nargs - 1, py_kwnames);
 
     if (ret == NULL || cache->return_cache->is_skipped)
         return ret;
@@ -1038,23 +1241,21 @@ pygi_method_cache_new (GICallableInfo *info)
 static PyObject *
 _vfunc_cache_invoke_real (PyGIFunctionCache *function_cache,
                           PyGIInvokeState *state,
-                          PyObject *py_args,
-                          PyObject *py_kwargs)
+                          PyObject *const *py_args,
+                          Py_ssize_t py_nargs,
+                          PyObject *py_kwnames)
 {
     PyGIVFuncCache *vfunc_cache = (PyGIVFuncCache *) function_cache;
-    PyObject *py_gtype;
     GType implementor_gtype;
     GError *error = NULL;
-    PyObject *ret;
 
-    py_gtype = PyTuple_GetItem (py_args, 0);
-    if (py_gtype == NULL) {
+    if (py_nargs < 1) {
         PyErr_SetString (PyExc_TypeError,
                          "need the GType of the implementor class");
         return FALSE;
     }
 
-    implementor_gtype = pyg_type_from_object (py_gtype);
+    implementor_gtype = pyg_type_from_object (py_args[0]);
     if (implementor_gtype == G_TYPE_INVALID)
         return FALSE;
 
@@ -1070,12 +1271,9 @@ _vfunc_cache_invoke_real (PyGIFunctionCache *function_cache,
         return FALSE;
     }
 
-    py_args = PyTuple_GetSlice (py_args, 1, PyTuple_Size (py_args));
-    ret = _function_cache_invoke_real (function_cache, state,
-                                       py_args, py_kwargs);
-    Py_DECREF (py_args);
-
-    return ret;
+    /* Skip the implementor GType, it is not passed on to C. */
+    return _function_cache_invoke_real (function_cache, state,
+                                        py_args + 1, py_nargs - 1, py_kwnames);
 }
 
 static void
@@ -1119,8 +1317,36 @@ pygi_vfunc_cache_new (GICallableInfo *info)
 
 /* PyGIClosureCache */
 
-PyGIClosureCache *
-pygi_closure_cache_new (GICallableInfo *info)
+/* Closure caches shared by all closures of a callable, keyed by the info of
+ * the callback or vfunc. Only accessed with the GIL held.
+ */
+static GHashTable *closure_caches = NULL;
+
+/* Hash functions for tables keyed by GIBaseInfo, different instances of
+ * the info of a callable are considered equal.
+ */
+guint
+_pygi_base_info_hash (gconstpointer info)
+{
+    return g_str_hash (g_base_info_get_name ((GIBaseInfo *) info));
+}
+
+gboolean
+_pygi_base_info_equal (gconstpointer info1, gconstpointer info2)
+{
+    return g_base_info_equal ((GIBaseInfo *) info1, (GIBaseInfo *) info2);
+}
+
+static void
+_closure_cache_deinit_real (PyGICallableCache *callable_cache)
+{
+    g_base_info_unref (((PyGIClosureCache *) callable_cache)->info);
+
+    _callable_cache_deinit_real (callable_cache);
+}
+
+static PyGIClosureCache *
+_closure_cache_new (GICallableInfo *info)
 {
     gssize i;
     PyGIClosureCache *closure_cache;
@@ -1130,6 +1356,7 @@ pygi_closure_cache_new (GICallableInfo *info)
     callable_cache = (PyGICallableCache *) closure_cache;
 
     callable_cache->calling_context = PYGI_CALLING_CONTEXT_IS_FROM_C;
+    callable_cache->deinit = _closure_cache_deinit_real;
 
     if (!_callable_cache_init (callable_cache, info)) {
         g_free (closure_cache);
@@ -1178,5 +1405,67 @@ pygi_closure_cache_new (GICallableInfo *info)
         }
     }
 
+    for (i = 0; i < _pygi_callable_cache_args_len (callable_cache); i++) {
+        PyGIArgCache *arg_cache;
+
+        arg_cache = g_ptr_array_index (callable_cache->args_cache, i);
+        if ((arg_cache->direction & PYGI_DIRECTION_TO_PYTHON) &&
+                (callable_cache->user_data_index == i ||
+                 arg_cache->meta_type == PYGI_META_ARG_TYPE_PARENT))
+            closure_cache->n_py_callback_args++;
+    }
+
+    return closure_cache;
+}
+
+/**
+ * pygi_closure_cache_ref_for_info:
+ * @info: info of the callback or vfunc
+ *
+ * Closure caches only depend on the info, so all closures of a callable
+ * share the same cache instead of building one per closure. The cache
+ * created on first use stays alive for further closures.
+ *
+ * Returns: (transfer full): the closure cache of @info, release with
+ *     pygi_closure_cache_unref(), or %NULL with an exception set.
+ */
+PyGIClosureCache *
+pygi_closure_cache_ref_for_info (GICallableInfo *info)
+{
+    PyGIClosureCache *closure_cache;
+
+    if (closure_caches == NULL)
+        closure_caches = g_hash_table_new (_pygi_base_info_hash,
+                                           _pygi_base_info_equal);
+
+    closure_cache = g_hash_table_lookup (closure_caches, info);
+    if (closure_cache == NULL) {
+        closure_cache = _closure_cache_new (info);
+        if (closure_cache == NULL)
+            return NULL;
+
+        /* The reference of the table */
+        closure_cache->ref_count = 1;
+        closure_cache->info = g_base_info_ref ((GIBaseInfo *) info);
+        g_hash_table_insert (closure_caches, closure_cache->info, closure_cache);
+    }
+
+    g_atomic_int_inc (&closure_cache->ref_count);
+
     return closure_cache;
 }
+
+/**
+ * pygi_closure_cache_unref:
+ * @closure_cache: closure cache
+ *
+ * Releases a reference obtained with pygi_closure_cache_ref_for_info().
+ * Can be called without the GIL, the last reference is owned by the table
+ * of shared caches.
+ */
+void
+pygi_closure_cache_unref (PyGIClosureCache *closure_cache)
+{
+    if (g_atomic_int_dec_and_test (&closure_cache->ref_count))
+        pygi_callable_cache_free ((PyGICallableCache *) closure_cache);
+}
@@ -26,6 +26,8 @@
 #include <girffi.h>
 
 #include "pygi-invoke-state-struct.h"
+#include "pygi-direct-call.h"
+#include "pygi-profiler.h"
 
 G_BEGIN_DECLS
 
@@ -33,12 +35,12 @@ typedef struct _PyGIArgCache PyGIArgCache;
 typedef struct _PyGICallableCache PyGICallableCache;
 typedef struct _PyGIFunctionCache PyGIFunctionCache;
 typedef struct _PyGIVFuncCache PyGIVFuncCache;
+typedef struct _PyGIClosureCache PyGIClosureCache;
 
 typedef PyGIFunctionCache PyGICCallbackCache;
 typedef PyGIFunctionCache PyGIConstructorCache;
 typedef PyGIFunctionCache PyGIFunctionWithInstanceCache;
 typedef PyGIFunctionCache PyGIMethodCache;
-typedef PyGICallableCache PyGIClosureCache;
 
 typedef gboolean (*PyGIMarshalFromPyFunc) (PyGIInvokeState   *state,
                                            PyGICallableCache *callable_cache,
@@ -155,6 +157,50 @@ typedef struct _PyGIInterfaceCache
     gchar *type_name;
 } PyGIInterfaceCache;
 
+typedef struct _PyGIArgName
+{
+    /* Interned Python string of the argument name or NULL for arguments
+     * which can't be passed by keyword (e.g. the instance argument).
+     */
+    PyObject *py_name;
+    const gchar *name;
+
+    /* Index into PyGICallableCache.args_cache or -1 without name. */
+    gssize arg_index;
+} PyGIArgName;
+
+/* Operations of the marshal plan, see PyGIMarshalStep. */
+typedef enum {
+    /* Handled by the marshallers of the argument cache */
+    PYGI_MARSHAL_OP_GENERIC = 0,
+    /* The user_data argument passed to a C callable */
+    PYGI_MARSHAL_OP_IN_CLOSURE,
+    /* "in" argument filled in by its parent argument */
+    PYGI_MARSHAL_OP_IN_CHILD,
+    /* "in" argument of a basic scalar type */
+    PYGI_MARSHAL_OP_IN_BASIC,
+    /* "out" argument which isn't caller allocated */
+    PYGI_MARSHAL_OP_OUT,
+    /* Basic scalar return value or "out" argument converted to Python */
+    PYGI_MARSHAL_OP_TO_PY_BASIC,
+} PyGIMarshalOp;
+
+/* A step of the marshal plan compiled from the argument caches. The plan
+ * keeps what is needed for marshaling the common simple arguments in one
+ * contiguous array, everything else is handled through arg_cache.
+ */
+typedef struct _PyGIMarshalStep
+{
+    PyGIMarshalOp op;
+    GITypeTag type_tag;
+    GITransfer transfer;
+
+    /* PyGIArgCache.py_arg_index for "in" steps, c_arg_index for "out" steps */
+    gssize index;
+
+    PyGIArgCache *arg_cache;
+} PyGIMarshalStep;
+
 struct _PyGICallableCache
 {
     const gchar *name;
@@ -166,8 +212,18 @@ struct _PyGICallableCache
     PyGIArgCache *return_cache;
     GPtrArray *args_cache;
     GSList *to_py_args;
-    GSList *arg_name_list; /* for keyword arg matching */
-    GHashTable *arg_name_hash;
+    /* For keyword arg matching, one entry per Python argument */
+    PyGIArgName *arg_names;
+    gssize n_arg_names;
+
+    /* One step per entry in args_cache for marshaling into C */
+    PyGIMarshalStep *in_plan;
+
+    /* One step per entry in to_py_args and one for the return value for
+     * marshaling back to Python.
+     */
+    PyGIMarshalStep *to_py_plan;
+    PyGIMarshalStep return_step;
     gboolean throws;
 
     /* Index of user_data arg passed to a callable. */
@@ -202,6 +258,9 @@ struct _PyGICallableCache
      * This count does not include args with defaults. */
     gssize n_py_required_args;
 
+    /* Statistics while the profiler is enabled, looked up on first use */
+    PyGIProfileStats *profile_stats;
+
     void     (*deinit)              (PyGICallableCache *callable_cache);
 
     gboolean (*generate_args_cache) (PyGICallableCache *callable_cache,
@@ -214,10 +273,21 @@ struct _PyGIFunctionCache {
     /* An invoker with ffi_cif already setup */
     GIFunctionInvoker invoker;
 
+    /* Calls the function without libffi for common signatures or NULL */
+    PyGIDirectCallFunc direct_call;
+
+    /* Whether the GIL is released while calling into C, see
+     * _function_cache_should_release_gil() for the default.
+     */
+    gboolean release_gil;
+
+    /* Invokes with a vector of positional arguments followed by the values
+     * of the keyword arguments named in py_kwnames. */
     PyObject *(*invoke) (PyGIFunctionCache *function_cache,
                          PyGIInvokeState *state,
-                         PyObject *py_args,
-                         PyObject *py_kwargs);
+                         PyObject *const *py_args,
+                         Py_ssize_t py_nargs,
+                         PyObject *py_kwnames);
 } ;
 
 struct _PyGIVFuncCache {
@@ -226,6 +296,19 @@ struct _PyGIVFuncCache {
     GIBaseInfo *info;
 };
 
+struct _PyGIClosureCache {
+    PyGICallableCache callable_cache;
+
+    /* Shared by all closures of the same callable, see
+     * pygi_closure_cache_ref_for_info() */
+    gint ref_count;
+    GIBaseInfo *info;
+
+    /* Number of arguments passed to the Python callback, the user data
+     * argument counts as one. */
+    gssize n_py_callback_args;
+};
+
 
 gboolean
 pygi_arg_base_setup      (PyGIArgCache *arg_cache,
@@ -279,13 +362,20 @@ pygi_callable_cache_free    (PyGICallableCache *cache);
 gchar *
 pygi_callable_cache_get_full_name (PyGICallableCache *cache);
 
+PyGIProfileStats *
+pygi_callable_cache_get_profile_stats (PyGICallableCache *cache);
+
 PyGIFunctionCache *
 pygi_function_cache_new     (GICallableInfo *info);
 
 PyObject *
 pygi_function_cache_invoke  (PyGIFunctionCache *function_cache,
-                             PyObject *py_args,
-                             PyObject *py_kwargs);
+                             PyObject *const *py_args,
+                             Py_ssize_t py_nargs,
+                             PyObject *py_kwnames);
+
+gboolean
+pygi_function_cache_invokes_directly (PyGIFunctionCache *function_cache);
 
 PyGIFunctionCache *
 pygi_ccallback_cache_new    (GICallableInfo *info,
@@ -293,8 +383,9 @@ pygi_ccallback_cache_new    (GICallableInfo *info,
 
 PyObject *
 pygi_ccallback_cache_invoke (PyGIFunctionCache *function_cache,
-                             PyObject *py_args,
-                             PyObject *py_kwargs,
+                             PyObject *const *py_args,
+                             Py_ssize_t py_nargs,
+                             PyObject *py_kwnames,
                              gpointer user_data);
 
 PyGIFunctionCache *
@@ -306,8 +397,18 @@ pygi_method_cache_new       (GICallableInfo *info);
 PyGIFunctionCache *
 pygi_vfunc_cache_new        (GICallableInfo *info);
 
+guint
+_pygi_base_info_hash        (gconstpointer info);
+
+gboolean
+_pygi_base_info_equal       (gconstpointer info1,
+                             gconstpointer info2);
+
 PyGIClosureCache *
-pygi_closure_cache_new      (GICallableInfo *info);
+pygi_closure_cache_ref_for_info (GICallableInfo *info);
+
+void
+pygi_closure_cache_unref    (PyGIClosureCache *closure_cache);
 
 #define _pygi_callable_cache_args_len(cache) ((cache)->args_cache)->len
 
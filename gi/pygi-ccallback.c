@@ -20,6 +20,7 @@
  */
 
 #include "pygi-ccallback.h"
+#include "pygi-invoke.h"
 
 #include <girepository.h>
 #include <pyglib-python-compat.h>
@@ -28,6 +29,7 @@
 static PyObject *
 _ccallback_call(PyGICCallback *self, PyObject *args, PyObject *kwargs)
 {
+    PyGIInvokeStack stack;
     PyObject *result;
 
     if (self->cache == NULL) {
@@ -37,10 +39,15 @@ _ccallback_call(PyGICCallback *self, PyObject *args, PyObject *kwargs)
             return NULL;
     }
 
+    if (!pygi_invoke_stack_init (&stack, NULL, args, kwargs))
+        return NULL;
+
     result = pygi_ccallback_cache_invoke (self->cache,
-                                          args,
-                                          kwargs,
+                                          stack.args,
+                                          stack.n_args,
+                                          stack.kwnames,
                                           self->user_data);
+    pygi_invoke_stack_clear (&stack);
     return result;
 }
 
@@ -302,17 +302,26 @@ _invoke_state_init_from_cache (PyGIInvokeState *state,
                                void **args)
 {
     PyGICallableCache *cache = (PyGICallableCache *) closure_cache;
+    gssize user_data_index = cache->user_data_index;
 
     state->n_args = _pygi_callable_cache_args_len (cache);
-    state->n_py_in_args = state->n_args;
+    state->n_py_in_args = closure_cache->n_py_callback_args;
+
+    /* Tuples of user data are passed as variable args, size the argument
+     * tuple for them up front. */
+    if (user_data_index >= 0 &&
+            (_pygi_callable_cache_get_arg (cache, user_data_index)->direction & PYGI_DIRECTION_TO_PYTHON) &&
+            state->user_data != NULL && PyTuple_Check (state->user_data)) {
+        state->n_py_in_args += PyTuple_GET_SIZE (state->user_data) - 1;
+    }
 
     /* Increment after setting the number of Python input args */
     if (cache->throws) {
         state->n_args++;
     }
 
-    state->py_in_args = PyTuple_New (state->n_py_in_args);
-    if (state->py_in_args == NULL) {
+    state->py_in_args_tuple = PyTuple_New (state->n_py_in_args);
+    if (state->py_in_args_tuple == NULL) {
         PyErr_NoMemory ();
         return FALSE;
     }
@@ -334,7 +343,7 @@ static void
 _invoke_state_clear (PyGIInvokeState *state)
 {
     _pygi_invoke_arg_state_free (state);
-    Py_XDECREF (state->py_in_args);
+    Py_XDECREF (state->py_in_args_tuple);
 }
 
 static gboolean
@@ -371,14 +380,11 @@ _pygi_closure_convert_arguments (PyGIInvokeState *state,
                         return FALSE;
                     }
 
-                    user_data_len = PyTuple_Size (py_user_data);
-                    _PyTuple_Resize (&state->py_in_args,
-                                     state->n_py_in_args + user_data_len - 1);
-
+                    user_data_len = PyTuple_GET_SIZE (py_user_data);
                     for (j = 0; j < user_data_len; j++, n_in_args++) {
                         value = PyTuple_GetItem (py_user_data, j);
                         Py_INCREF (value);
-                        PyTuple_SET_ITEM (state->py_in_args, n_in_args, value);
+                        PyTuple_SET_ITEM (state->py_in_args_tuple, n_in_args, value);
                     }
                     /* We can assume user_data args are never going to be inout,
                      * so just continue here.
@@ -401,13 +407,14 @@ _pygi_closure_convert_arguments (PyGIInvokeState *state,
                 }
             }
 
-            PyTuple_SET_ITEM (state->py_in_args, n_in_args, value);
+            PyTuple_SET_ITEM (state->py_in_args_tuple, n_in_args, value);
             n_in_args++;
         }
     }
 
-    if (_PyTuple_Resize (&state->py_in_args, n_in_args) == -1)
-        return FALSE;
+    g_assert (n_in_args == state->n_py_in_args);
+
+    state->py_in_args = &PyTuple_GET_ITEM (state->py_in_args_tuple, 0);
 
     return TRUE;
 }
@@ -542,6 +549,7 @@ _pygi_closure_handle (ffi_cif *cif,
 {
     PyGILState_STATE py_state;
     PyGICClosure *closure = data;
+    PyGICallableCache *cache;
     PyObject *retval;
     gboolean success;
     PyGIInvokeState state = { 0, };
@@ -558,34 +566,39 @@ _pygi_closure_handle (ffi_cif *cif,
     py_state = PyGILState_Ensure ();
 
     if (closure->cache == NULL) {
-        closure->cache = pygi_closure_cache_new ((GICallableInfo *) closure->info);
+        closure->cache = pygi_closure_cache_ref_for_info ((GICallableInfo *) closure->info);
 
         if (closure->cache == NULL)
             goto end;
     }
 
+    cache = (PyGICallableCache *) closure->cache;
+
+    if (PYGI_PROFILER_IS_ENABLED ())
+        pygi_callable_cache_get_profile_stats (cache)->closure_calls++;
+
     state.user_data = closure->user_data;
 
     _invoke_state_init_from_cache (&state, closure->cache, args);
 
     if (!_pygi_closure_convert_arguments (&state, closure->cache)) {
-        _pygi_closure_clear_retvals (&state, closure->cache, result);
+        _pygi_closure_clear_retvals (&state, cache, result);
         goto end;
     }
 
-    retval = PyObject_CallObject ( (PyObject *) closure->function, state.py_in_args);
+    retval = PyObject_CallObject ( (PyObject *) closure->function, state.py_in_args_tuple);
 
     if (retval == NULL) {
-        _pygi_closure_clear_retvals (&state, closure->cache, result);
+        _pygi_closure_clear_retvals (&state, cache, result);
         goto end;
     }
 
-    pygi_marshal_cleanup_args_to_py_marshal_success (&state, closure->cache);
-    success = _pygi_closure_set_out_arguments (&state, closure->cache, retval, result);
+    pygi_marshal_cleanup_args_to_py_marshal_success (&state, cache);
+    success = _pygi_closure_set_out_arguments (&state, cache, retval, result);
 
     if (!success) {
-        pygi_marshal_cleanup_args_from_py_marshal_success (&state, closure->cache);
-        _pygi_closure_clear_retvals (&state, closure->cache, result);
+        pygi_marshal_cleanup_args_from_py_marshal_success (&state, cache);
+        _pygi_closure_clear_retvals (&state, cache, result);
     }
 
     Py_DECREF (retval);
@@ -622,10 +635,31 @@ end:
     PyGILState_Release (py_state);
 }
 
-void _pygi_invoke_closure_free (gpointer data)
-{
-    PyGICClosure* invoke_closure = (PyGICClosure *) data;
+/* Preparing a closure allocates executable memory for its trampoline,
+ * which is slow and fragments memory in processes creating lots of short
+ * lived callbacks. Freed closures are kept prepared in a pool per callable
+ * and handed out again for the next callback of the same type. The ffi
+ * closure stays bound to its PyGICClosure, only the Python data is reset.
+ *
+ * Closures can be freed from destroy notifies in any thread, so the pools
+ * are protected by a lock.
+ */
+#define PYGI_CLOSURE_POOL_MAX_PER_INFO 16
+
+typedef struct {
+    GSList *closures;
+    guint n_closures;
+} PyGIClosurePool;
 
+G_LOCK_DEFINE_STATIC (closure_pools);
+static GHashTable *closure_pools = NULL;
+static gsize closure_pool_hits = 0;
+static gsize closure_pool_misses = 0;
+static gsize closure_pool_discarded = 0;
+
+static void
+_pygi_closure_destroy (PyGICClosure *invoke_closure)
+{
     g_callable_info_free_closure (invoke_closure->info,
                                   invoke_closure->closure);
 
@@ -633,11 +667,111 @@ void _pygi_invoke_closure_free (gpointer data)
         g_base_info_unref ( (GIBaseInfo*) invoke_closure->info);
 
     if (invoke_closure->cache != NULL)
-        pygi_callable_cache_free ((PyGICallableCache *) invoke_closure->cache);
+        pygi_closure_cache_unref (invoke_closure->cache);
+
+    g_slice_free (PyGICClosure, invoke_closure);
+}
+
+/* Returns: a prepared closure for @info from the pool or %NULL */
+static PyGICClosure *
+_pygi_closure_pool_pop (GICallableInfo *info)
+{
+    PyGIClosurePool *pool = NULL;
+    PyGICClosure *closure = NULL;
+
+    G_LOCK (closure_pools);
+
+    if (closure_pools != NULL)
+        pool = g_hash_table_lookup (closure_pools, info);
+
+    if (pool != NULL && pool->closures != NULL) {
+        closure = pool->closures->data;
+        pool->closures = g_slist_delete_link (pool->closures, pool->closures);
+        pool->n_closures--;
+        closure_pool_hits++;
+    } else {
+        closure_pool_misses++;
+    }
+
+    G_UNLOCK (closure_pools);
+
+    return closure;
+}
+
+/* Returns: %TRUE if @closure was added to the pool of its info */
+static gboolean
+_pygi_closure_pool_push (PyGICClosure *closure)
+{
+    PyGIClosurePool *pool;
+    gboolean pushed = FALSE;
+
+    G_LOCK (closure_pools);
+
+    if (closure_pools == NULL)
+        closure_pools = g_hash_table_new_full (_pygi_base_info_hash,
+                                               _pygi_base_info_equal,
+                                               (GDestroyNotify) g_base_info_unref,
+                                               NULL);
+
+    pool = g_hash_table_lookup (closure_pools, closure->info);
+    if (pool == NULL) {
+        pool = g_new0 (PyGIClosurePool, 1);
+        g_hash_table_insert (closure_pools,
+                             g_base_info_ref ((GIBaseInfo *) closure->info),
+                             pool);
+    }
+
+    if (pool->n_closures < PYGI_CLOSURE_POOL_MAX_PER_INFO) {
+        pool->closures = g_slist_prepend (pool->closures, closure);
+        pool->n_closures++;
+        pushed = TRUE;
+    } else {
+        closure_pool_discarded++;
+    }
+
+    G_UNLOCK (closure_pools);
+
+    return pushed;
+}
+
+/**
+ * _pygi_closure_pool_stats:
+ * @hits: (out): closures reused from the pool
+ * @misses: (out): closures which had to be prepared
+ * @discarded: (out): freed closures which did not fit into the pool
+ * @pooled: (out): closures currently in the pools
+ */
+void
+_pygi_closure_pool_stats (gsize *hits, gsize *misses, gsize *discarded,
+                          gsize *pooled)
+{
+    GHashTableIter iter;
+    PyGIClosurePool *pool;
+
+    G_LOCK (closure_pools);
+
+    *hits = closure_pool_hits;
+    *misses = closure_pool_misses;
+    *discarded = closure_pool_discarded;
+    *pooled = 0;
+
+    if (closure_pools != NULL) {
+        g_hash_table_iter_init (&iter, closure_pools);
+        while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &pool))
+            *pooled += pool->n_closures;
+    }
+
+    G_UNLOCK (closure_pools);
+}
+
+void _pygi_invoke_closure_free (gpointer data)
+{
+    PyGICClosure* invoke_closure = (PyGICClosure *) data;
 
     _pygi_invoke_closure_clear_py_data(invoke_closure);
 
-    g_slice_free (PyGICClosure, invoke_closure);
+    if (!_pygi_closure_pool_push (invoke_closure))
+        _pygi_closure_destroy (invoke_closure);
 }
 
 
@@ -648,26 +782,27 @@ _pygi_make_native_closure (GICallableInfo* info,
                            gpointer py_user_data)
 {
     PyGICClosure *closure;
-    ffi_closure *fficlosure;
 
     /* Begin by cleaning up old async functions */
     g_slist_free_full (async_free_list, (GDestroyNotify) _pygi_invoke_closure_free);
     async_free_list = NULL;
 
-    /* Build the closure itself */
-    closure = g_slice_new0 (PyGICClosure);
-    closure->info = (GICallableInfo *) g_base_info_ref ( (GIBaseInfo *) info);
+    /* Build the closure itself, or reuse a prepared one */
+    closure = _pygi_closure_pool_pop (info);
+    if (closure == NULL) {
+        closure = g_slice_new0 (PyGICClosure);
+        closure->info = (GICallableInfo *) g_base_info_ref ( (GIBaseInfo *) info);
+        closure->closure =
+            g_callable_info_prepare_closure (info, &closure->cif, _pygi_closure_handle,
+                                             closure);
+    }
+
     closure->function = py_function;
     closure->user_data = py_user_data;
 
     Py_INCREF (py_function);
     Py_XINCREF (closure->user_data);
 
-    fficlosure =
-        g_callable_info_prepare_closure (info, &closure->cif, _pygi_closure_handle,
-                                         closure);
-    closure->closure = fficlosure;
-
     /* Give the closure the information it needs to determine when
        to free itself later */
     closure->scope = scope;
@@ -705,9 +840,11 @@ _pygi_marshal_from_py_interface_callback (PyGIInvokeState   *state,
         user_data_cache = _pygi_callable_cache_get_arg (callable_cache, callback_cache->user_data_index);
         if (user_data_cache->py_arg_index < state->n_py_in_args) {
             /* py_user_data is a borrowed reference. */
-            py_user_data = PyTuple_GetItem (state->py_in_args, user_data_cache->py_arg_index);
-            if (!py_user_data)
+            py_user_data = state->py_in_args[user_data_cache->py_arg_index];
+            if (!py_user_data) {
+                PyErr_SetString (PyExc_IndexError, "user data argument index out of range");
                 return FALSE;
+            }
             /* NULL out user_data if it was not supplied and the default arg placeholder
              * was used instead.
              */
@@ -721,7 +858,7 @@ _pygi_marshal_from_py_interface_callback (PyGIInvokeState   *state,
                  */
                 py_user_data = Py_BuildValue("(O)", py_user_data, NULL);
             } else {
-                /* increment the ref borrowed from PyTuple_GetItem above */
+                /* increment the ref borrowed from py_in_args above */
                 Py_INCREF (py_user_data);
             }
         }
@@ -49,6 +49,11 @@ void _pygi_closure_handle (ffi_cif *cif, void *result, void
 
 void _pygi_invoke_closure_free (gpointer user_data);
 
+void _pygi_closure_pool_stats (gsize *hits,
+                               gsize *misses,
+                               gsize *discarded,
+                               gsize *pooled);
+
 PyGICClosure* _pygi_make_native_closure (GICallableInfo* info,
                                          GIScopeType scope,
                                          PyObject *function,
@@ -0,0 +1,205 @@
+/* -*- Mode: C; c-basic-offset: 4 -*-
+ * vim: tabstop=4 shiftwidth=4 expandtab
+ *
+ *   pygi-direct-call.c: direct calls for common signatures
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+
+#include "pygi-direct-call.h"
+
+/* Most functions called through introspection take and return only
+ * pointers, 32 bit integers (including gboolean and enums) and doubles.
+ * For a set of common signatures we have C functions calling the function
+ * pointer directly, which is a lot cheaper than going through ffi_call().
+ *
+ * Signatures are written as one character for the return type followed by
+ * one character per argument:
+ *  - 'v' void (return only)
+ *  - 'p' pointer
+ *  - 'i' 32 bit signed integer
+ *  - 'u' 32 bit unsigned integer
+ *  - 'd' double
+ *
+ * Results are stored like ffi_call() does, integers are widened to the
+ * size of ffi_arg, so gi_type_info_extract_ffi_return_value() works the
+ * same for both.
+ */
+
+#define PYGI_DIRECT_CALL_MAX_ARGS 3
+
+#define _T_v void
+#define _T_p gpointer
+#define _T_i gint32
+#define _T_u guint32
+#define _T_d gdouble
+
+#define _A_p(i) args[i]->v_pointer
+#define _A_i(i) args[i]->v_int32
+#define _A_u(i) args[i]->v_uint32
+#define _A_d(i) args[i]->v_double
+
+#define _R_v(call) (call)
+#define _R_p(call) (*(gpointer *) return_value = (call))
+#define _R_i(call) (*(ffi_sarg *) return_value = (call))
+#define _R_u(call) (*(ffi_arg *) return_value = (call))
+#define _R_d(call) (*(gdouble *) return_value = (call))
+
+#define _DIRECT_CALL0(r) \
+static void \
+_direct_call_##r (gpointer function_ptr, GIArgument **args, gpointer return_value) \
+{ \
+    _R_##r (((_T_##r (*) (void)) function_ptr) ()); \
+}
+
+#define _DIRECT_CALL1(r, a) \
+static void \
+_direct_call_##r##a (gpointer function_ptr, GIArgument **args, gpointer return_value) \
+{ \
+    _R_##r (((_T_##r (*) (_T_##a)) function_ptr) (_A_##a (0))); \
+}
+
+#define _DIRECT_CALL2(r, a, b) \
+static void \
+_direct_call_##r##a##b (gpointer function_ptr, GIArgument **args, gpointer return_value) \
+{ \
+    _R_##r (((_T_##r (*) (_T_##a, _T_##b)) function_ptr) (_A_##a (0), _A_##b (1))); \
+}
+
+#define _DIRECT_CALL3(r, a, b, c) \
+static void \
+_direct_call_##r##a##b##c (gpointer function_ptr, GIArgument **args, gpointer return_value) \
+{ \
+    _R_##r (((_T_##r (*) (_T_##a, _T_##b, _T_##c)) function_ptr) (_A_##a (0), _A_##b (1), _A_##c (2))); \
+}
+
+_DIRECT_CALL0 (v)
+_DIRECT_CALL0 (p)
+_DIRECT_CALL0 (i)
+_DIRECT_CALL0 (u)
+_DIRECT_CALL0 (d)
+
+_DIRECT_CALL1 (v, p)
+_DIRECT_CALL1 (p, p)
+_DIRECT_CALL1 (i, p)
+_DIRECT_CALL1 (u, p)
+_DIRECT_CALL1 (d, p)
+_DIRECT_CALL1 (v, i)
+_DIRECT_CALL1 (v, u)
+_DIRECT_CALL1 (v, d)
+_DIRECT_CALL1 (p, i)
+_DIRECT_CALL1 (i, i)
+
+_DIRECT_CALL2 (v, p, p)
+_DIRECT_CALL2 (v, p, i)
+_DIRECT_CALL2 (v, p, u)
+_DIRECT_CALL2 (v, p, d)
+_DIRECT_CALL2 (p, p, p)
+_DIRECT_CALL2 (p, p, i)
+_DIRECT_CALL2 (i, p, p)
+_DIRECT_CALL2 (i, p, i)
+
+_DIRECT_CALL3 (v, p, p, p)
+_DIRECT_CALL3 (v, p, i, i)
+_DIRECT_CALL3 (v, p, d, d)
+_DIRECT_CALL3 (p, p, p, p)
+_DIRECT_CALL3 (i, p, p, p)
+
+static const struct {
+    const gchar *signature;
+    PyGIDirectCallFunc func;
+} direct_calls[] = {
+    { "v", _direct_call_v },
+    { "p", _direct_call_p },
+    { "i", _direct_call_i },
+    { "u", _direct_call_u },
+    { "d", _direct_call_d },
+    { "vp", _direct_call_vp },
+    { "pp", _direct_call_pp },
+    { "ip", _direct_call_ip },
+    { "up", _direct_call_up },
+    { "dp", _direct_call_dp },
+    { "vi", _direct_call_vi },
+    { "vu", _direct_call_vu },
+    { "vd", _direct_call_vd },
+    { "pi", _direct_call_pi },
+    { "ii", _direct_call_ii },
+    { "vpp", _direct_call_vpp },
+    { "vpi", _direct_call_vpi },
+    { "vpu", _direct_call_vpu },
+    { "vpd", _direct_call_vpd },
+    { "ppp", _direct_call_ppp },
+    { "ppi", _direct_call_ppi },
+    { "ipp", _direct_call_ipp },
+    { "ipi", _direct_call_ipi },
+    { "vppp", _direct_call_vppp },
+    { "vpii", _direct_call_vpii },
+    { "vpdd", _direct_call_vpdd },
+    { "pppp", _direct_call_pppp },
+    { "ippp", _direct_call_ippp },
+};
+
+static gchar
+_ffi_type_to_signature_char (ffi_type *type)
+{
+    if (type == &ffi_type_void)
+        return 'v';
+    else if (type == &ffi_type_pointer)
+        return 'p';
+    else if (type == &ffi_type_sint32)
+        return 'i';
+    else if (type == &ffi_type_uint32)
+        return 'u';
+    else if (type == &ffi_type_double)
+        return 'd';
+
+    return '\0';
+}
+
+/**
+ * pygi_direct_call_lookup:
+ * @cif: prepared call interface of the function
+ *
+ * Returns: a function calling functions with the signature described by
+ *     @cif directly or %NULL if ffi_call() has to be used.
+ */
+PyGIDirectCallFunc
+pygi_direct_call_lookup (ffi_cif *cif)
+{
+    gchar signature[PYGI_DIRECT_CALL_MAX_ARGS + 2];
+    guint i;
+
+    if (cif->abi != FFI_DEFAULT_ABI || cif->nargs > PYGI_DIRECT_CALL_MAX_ARGS)
+        return NULL;
+
+    signature[0] = _ffi_type_to_signature_char (cif->rtype);
+    if (signature[0] == '\0')
+        return NULL;
+
+    for (i = 0; i < cif->nargs; i++) {
+        signature[i + 1] = _ffi_type_to_signature_char (cif->arg_types[i]);
+        if (signature[i + 1] == '\0' || signature[i + 1] == 'v')
+            return NULL;
+    }
+    signature[cif->nargs + 1] = '\0';
+
+    for (i = 0; i < G_N_ELEMENTS (direct_calls); i++) {
+        if (strcmp (direct_calls[i].signature, signature) == 0)
+            return direct_calls[i].func;
+    }
+
+    return NULL;
+}
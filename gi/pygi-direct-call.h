@@ -0,0 +1,39 @@
+/* -*- Mode: C; c-basic-offset: 4 -*-
+ * vim: tabstop=4 shiftwidth=4 expandtab
+ *
+ *   pygi-direct-call.h: direct calls for common signatures
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __PYGI_DIRECT_CALL_H__
+#define __PYGI_DIRECT_CALL_H__
+
+#include <girepository.h>
+#include <girffi.h>
+
+G_BEGIN_DECLS
+
+/* Calls @function_ptr with the arguments in @args and stores the result in
+ * @return_value the same way ffi_call() does.
+ */
+typedef void (*PyGIDirectCallFunc) (gpointer    function_ptr,
+                                     GIArgument **args,
+                                     gpointer     return_value);
+
+PyGIDirectCallFunc pygi_direct_call_lookup (ffi_cif *cif);
+
+G_END_DECLS
+
+#endif /* __PYGI_DIRECT_CALL_H__ */
@@ -537,40 +537,38 @@ PYGLIB_DEFINE_TYPE ("gi.CallableInfo", PyGICallableInfo_Type, PyGICallableInfo);
 static PyObject *
 _callable_info_call (PyGICallableInfo *self, PyObject *args, PyObject *kwargs)
 {
-    /* Insert the bound arg at the beginning of the invoke method args. */
-    if (self->py_bound_arg) {
-        int i;
-        PyObject *result;
-        Py_ssize_t argcount = PyTuple_Size (args);
-        PyObject *newargs = PyTuple_New (argcount + 1);
-        if (newargs == NULL)
-            return NULL;
-
-        Py_INCREF (self->py_bound_arg);
-        PyTuple_SET_ITEM (newargs, 0, self->py_bound_arg);
+    PyGIInvokeStack stack;
+    PyObject *result;
 
-        for (i = 0; i < argcount; i++) {
-            PyObject *v = PyTuple_GET_ITEM (args, i);
-            Py_XINCREF (v);
-            PyTuple_SET_ITEM (newargs, i+1, v);
-        }
+    /* Insert the bound arg at the beginning of the invoke method args.
+     * The argument vector lives on the C stack for the common case, so no
+     * new tuple is created for the call.
+     */
+    if (!pygi_invoke_stack_init (&stack, self->py_bound_arg, args, kwargs))
+        return NULL;
 
+    if (self->py_bound_arg) {
         /* Invoke with the original GI info struct this wrapper was based upon.
          * This is necessary to maintain the same cache for all bound versions.
          */
-        result = _wrap_g_callable_info_invoke ((PyGIBaseInfo *)self->py_unbound_info,
-                                               newargs, kwargs);
-        Py_DECREF (newargs);
-        return result;
-
+        result = _wrap_g_callable_info_invoke_vector ((PyGIBaseInfo *)self->py_unbound_info,
+                                                      stack.args,
+                                                      stack.n_args,
+                                                      stack.kwnames);
     } else {
         /* We should never have an unbound info when calling when calling invoke
          * at this point because the descriptor implementation on sub-classes
          * should return "self" not a copy when there is no bound arg.
          */
         g_assert (self->py_unbound_info == NULL);
-        return _wrap_g_callable_info_invoke ((PyGIBaseInfo *)self, args, kwargs);
+        result = _wrap_g_callable_info_invoke_vector ((PyGIBaseInfo *)self,
+                                                      stack.args,
+                                                      stack.n_args,
+                                                      stack.kwnames);
     }
+
+    pygi_invoke_stack_clear (&stack);
+    return result;
 }
 
 
@@ -627,6 +625,14 @@ _function_info_call (PyGICallableInfo *self, PyObject *args, PyObject *kwargs)
     return _callable_info_call (self, args, kwargs);
 }
 
+/* Bound function infos are created for every "obj.method" lookup and are
+ * usually released right after the call. Keep a few of them around for
+ * reuse so method calls on instances do not need to allocate.
+ */
+#define PYGI_BOUND_INFO_FREE_LIST_MAX 16
+static PyGICallableInfo *bound_info_free_list[PYGI_BOUND_INFO_FREE_LIST_MAX];
+static int bound_info_free_list_len = 0;
+
 /* _new_bound_callable_info
  *
  * Utility function for sub-classes to create a bound version of themself.
@@ -642,9 +648,17 @@ _new_bound_callable_info (PyGICallableInfo *self, PyObject *bound_arg)
         return self;
     }
 
-    new_self = (PyGICallableInfo *)_pygi_info_new (self->base.info);
-    if (new_self == NULL)
-        return NULL;
+    if (Py_TYPE (self) == &PyGIFunctionInfo_Type && bound_info_free_list_len > 0) {
+        new_self = bound_info_free_list[--bound_info_free_list_len];
+        PyObject_INIT (new_self, &PyGIFunctionInfo_Type);
+        new_self->base.info = g_base_info_ref (self->base.info);
+        new_self->base.inst_weakreflist = NULL;
+        new_self->base.cache = NULL;
+    } else {
+        new_self = (PyGICallableInfo *)_pygi_info_new (self->base.info);
+        if (new_self == NULL)
+            return NULL;
+    }
 
     Py_INCREF ((PyObject *)self);
     new_self->py_unbound_info = (struct PyGICallableInfo *)self;
@@ -699,9 +713,27 @@ _vfunc_info_descr_get (PyGICallableInfo *self, PyObject *obj, PyObject *type) {
 static void
 _callable_info_dealloc (PyGICallableInfo *self)
 {
+    gboolean is_bound = self->py_unbound_info != NULL;
+
     Py_CLEAR (self->py_unbound_info);
     Py_CLEAR (self->py_bound_arg);
 
+    /* Recycle bound function infos, see _new_bound_callable_info. Bound
+     * infos never create a cache as invoke goes through the unbound info.
+     */
+    if (is_bound && Py_TYPE (self) == &PyGIFunctionInfo_Type &&
+            self->base.cache == NULL &&
+            bound_info_free_list_len < PYGI_BOUND_INFO_FREE_LIST_MAX) {
+        if (self->base.inst_weakreflist != NULL)
+            PyObject_ClearWeakRefs ( (PyObject *) self);
+
+        g_base_info_unref (self->base.info);
+        self->base.info = NULL;
+
+        bound_info_free_list[bound_info_free_list_len++] = self;
+        return;
+    }
+
     PyGIBaseInfo_Type.tp_dealloc ((PyObject *) self);
 }
 
@@ -25,9 +25,28 @@ typedef struct _PyGIInvokeArgState
 
 typedef struct _PyGIInvokeState
 {
-    PyObject *py_in_args;
+    /* Array of Python input arguments indexed by PyGIArgCache.py_arg_index.
+     * When invoking from Python this is either the caller's argument vector
+     * or py_in_args_buffer when keyword arguments had to be merged in. For
+     * closures it points at the items of py_in_args_tuple.
+     * The references are borrowed.
+     */
+    PyObject **py_in_args;
     gssize n_py_in_args;
 
+    /* Storage for merging positional and keyword arguments, part of the
+     * memory allocated by _pygi_invoke_arg_state_init().
+     */
+    PyObject **py_in_args_buffer;
+
+    /* New reference to the tuple holding variable user data arguments
+     * placed into py_in_args, if any.
+     */
+    PyObject *py_user_data_varargs;
+
+    /* Tuple of arguments passed to Python when invoking closures. */
+    PyObject *py_in_args_tuple;
+
     /* Number of arguments the ffi wrapped C function takes. Used as the exact
      * count for argument related arrays held in this struct.
      */
@@ -27,19 +27,77 @@
 #include "pygi-resulttuple.h"
 #include "pygi-foreign.h"
 #include "pygi-boxed.h"
+#include "pygi-basictype.h"
 
 extern PyObject *_PyGIDefaultArgPlaceholder;
 
+/* _find_arg_name:
+ *
+ * Returns the index into PyGICallableCache.arg_names of the argument named
+ * @py_kwname or -1. Keyword names used in Python code are interned just like
+ * the cached names, so they are matched by identity first.
+ */
+static gssize
+_find_arg_name (PyGICallableCache *cache, PyObject *py_kwname)
+{
+    gssize i;
+
+    for (i = 0; i < cache->n_arg_names; i++) {
+        if (cache->arg_names[i].py_name == py_kwname)
+            return i;
+    }
+
+    /* An interned string which didn't match by identity can't be equal. */
+#if PY_VERSION_HEX < 0x03000000
+    if (PyString_CheckExact (py_kwname) && PyString_CHECK_INTERNED (py_kwname))
+        return -1;
+#else
+    if (PyUnicode_CheckExact (py_kwname) && PyUnicode_CHECK_INTERNED (py_kwname))
+        return -1;
+#endif
+
+    for (i = 0; i < cache->n_arg_names; i++) {
+        PyObject *py_name = cache->arg_names[i].py_name;
+        int res;
+
+        if (py_name == NULL)
+            continue;
+
+        res = PyObject_RichCompareBool (py_kwname, py_name, Py_EQ);
+        if (res < 0)
+            PyErr_Clear ();
+        else if (res > 0)
+            return i;
+    }
+
+    return -1;
+}
+
+/* _match_kwargs:
+ * @py_kwnames: tuple of keyword argument names
+ * @py_kwvalues: keyword argument values matching py_kwnames
+ * @kw_args: vector of n_arg_names items receiving the borrowed values
+ *
+ * Returns: FALSE with an exception set if a keyword doesn't name an argument.
+ */
 static gboolean
-_check_for_unexpected_kwargs (PyGICallableCache *cache,
-                              GHashTable  *arg_name_hash,
-                              PyObject    *py_kwargs)
+_match_kwargs (PyGICallableCache *cache,
+               PyObject          *py_kwnames,
+               PyObject *const   *py_kwvalues,
+               PyObject         **kw_args)
 {
-    PyObject *dict_key, *dict_value;
-    Py_ssize_t dict_iter_pos = 0;
+    Py_ssize_t i, n_kwnames = PyTuple_GET_SIZE (py_kwnames);
 
-    while (PyDict_Next (py_kwargs, &dict_iter_pos, &dict_key, &dict_value)) {
+    for (i = 0; i < n_kwnames; i++) {
+        PyObject *dict_key = PyTuple_GET_ITEM (py_kwnames, i);
+        gssize index = _find_arg_name (cache, dict_key);
         PyObject *key;
+        char *full_name;
+
+        if (index >= 0) {
+            kw_args[index] = py_kwvalues[i];
+            continue;
+        }
 
 #if PY_VERSION_HEX < 0x03000000
         if (PyString_Check (dict_key)) {
@@ -54,54 +112,57 @@ _check_for_unexpected_kwargs (PyGICallableCache *cache,
             }
         }
 
-        /* Use extended lookup because it returns whether or not the key actually
-         * exists in the hash table. g_hash_table_lookup returns NULL for keys not
-         * found which maps to index 0 for our hash lookup.
-         */
-        if (!g_hash_table_lookup_extended (arg_name_hash, PyBytes_AsString(key), NULL, NULL)) {
-            char *full_name = pygi_callable_cache_get_full_name (cache);
-            PyErr_Format (PyExc_TypeError,
-                          "%.200s() got an unexpected keyword argument '%.400s'",
-                          full_name,
-                          PyBytes_AsString (key));
-            Py_DECREF (key);
-            g_free (full_name);
-            return FALSE;
-        }
-
+        full_name = pygi_callable_cache_get_full_name (cache);
+        PyErr_Format (PyExc_TypeError,
+                      "%.200s() got an unexpected keyword argument '%.400s'",
+                      full_name,
+                      PyBytes_AsString (key));
         Py_DECREF (key);
+        g_free (full_name);
+        return FALSE;
     }
+
     return TRUE;
 }
 
 /**
  * _py_args_combine_and_check_length:
+ * @state: PyGIInvokeState to fill in py_in_args and n_py_in_args for.
  * @cache: PyGICallableCache
- * @py_args: the tuple of positional arguments.
- * @py_kwargs: the dict of keyword arguments to be merged with py_args.
+ * @py_args: vector of positional arguments, followed by the values of the
+ *     keyword arguments named in py_kwnames.
+ * @n_py_args: the number of positional arguments in py_args.
+ * @py_kwnames: (allow-none): tuple of keyword argument names to be merged
+ *     with the positional arguments.
+ *
+ * When the positional arguments already match the callable, state->py_in_args
+ * points directly at py_args. Otherwise the arguments are merged into
+ * state->py_in_args_buffer without creating an intermediate tuple.
  *
- * Returns: New value reference to the combined py_args and py_kwargs.
+ * Returns: FALSE with an exception set on failure.
  */
-static PyObject *
-_py_args_combine_and_check_length (PyGICallableCache *cache,
-                                   PyObject    *py_args,
-                                   PyObject    *py_kwargs)
+static gboolean
+_py_args_combine_and_check_length (PyGIInvokeState   *state,
+                                   PyGICallableCache *cache,
+                                   PyObject *const   *py_args,
+                                   Py_ssize_t         n_py_args,
+                                   PyObject          *py_kwnames)
 {
-    PyObject *combined_py_args = NULL;
-    Py_ssize_t n_py_args, n_py_kwargs, i;
+    PyObject **combined_py_args = NULL;
+    PyObject *const *py_kwvalues = py_args + n_py_args;
+    Py_ssize_t n_py_kwargs, i;
     guint n_expected_args = cache->n_py_args;
-    GSList *l;
 
-    n_py_args = PyTuple_GET_SIZE (py_args);
-    if (py_kwargs == NULL)
+    if (py_kwnames == NULL)
         n_py_kwargs = 0;
     else
-        n_py_kwargs = PyDict_Size (py_kwargs);
+        n_py_kwargs = PyTuple_GET_SIZE (py_kwnames);
 
     /* Fast path, we already have the exact number of args and not kwargs. */
     if (n_py_kwargs == 0 && n_py_args == n_expected_args && cache->user_data_varargs_index < 0) {
-        Py_INCREF (py_args);
-        return py_args;
+        state->py_in_args = (PyObject **) py_args;
+        state->n_py_in_args = n_py_args;
+        return TRUE;
     }
 
     if (cache->user_data_varargs_index < 0 && n_expected_args < n_py_args) {
@@ -114,7 +175,7 @@ _py_args_combine_and_check_length (PyGICallableCache *cache,
                       n_expected_args == 1 ? "" : "s",
                       n_py_args);
         g_free (full_name);
-        return NULL;
+        return FALSE;
     }
 
     if (cache->user_data_varargs_index >= 0 && n_py_kwargs > 0 && n_expected_args < n_py_args) {
@@ -123,51 +184,59 @@ _py_args_combine_and_check_length (PyGICallableCache *cache,
                       "%.200s() cannot use variable user data arguments with keyword arguments",
                       full_name);
         g_free (full_name);
-        return NULL;
+        return FALSE;
     }
 
-    if (n_py_kwargs > 0 && !_check_for_unexpected_kwargs (cache,
-                                                          cache->arg_name_hash,
-                                                          py_kwargs)) {
-        return NULL;
-    }
+    /* will hold arguments from both py_args and the keyword arguments
+     * when they are combined into a single argument vector */
+    combined_py_args = state->py_in_args_buffer;
+    state->py_in_args = combined_py_args;
+    state->n_py_in_args = n_expected_args;
+
+    /* Place the keyword arguments first, they get picked up per argument
+     * in the loop below.
+     */
+    for (i = 0; i < n_expected_args; i++)
+        combined_py_args[i] = NULL;
 
-    /* will hold arguments from both py_args and py_kwargs
-     * when they are combined into a single tuple */
-    combined_py_args = PyTuple_New (n_expected_args);
+    if (n_py_kwargs > 0 && !_match_kwargs (cache,
+                                           py_kwnames,
+                                           py_kwvalues,
+                                           combined_py_args)) {
+        return FALSE;
+    }
 
-    for (i = 0, l = cache->arg_name_list; i < n_expected_args && l; i++, l = l->next) {
+    for (i = 0; i < n_expected_args && i < cache->n_arg_names; i++) {
         PyObject *py_arg_item = NULL;
-        PyObject *kw_arg_item = NULL;
-        const gchar *arg_name = l->data;
-        int arg_cache_index = -1;
+        PyObject *kw_arg_item = combined_py_args[i];
+        const gchar *arg_name = cache->arg_names[i].name;
+        gssize arg_cache_index = cache->arg_names[i].arg_index;
         gboolean is_varargs_user_data = FALSE;
 
-        if (arg_name != NULL)
-            arg_cache_index = GPOINTER_TO_INT (g_hash_table_lookup (cache->arg_name_hash, arg_name));
-
         is_varargs_user_data = cache->user_data_varargs_index >= 0 &&
                                 arg_cache_index == cache->user_data_varargs_index;
 
-        if (n_py_kwargs > 0 && arg_name != NULL) {
-            /* NULL means this argument has no keyword name */
-            /* ex. the first argument to a method or constructor */
-            kw_arg_item = PyDict_GetItemString (py_kwargs, arg_name);
-        }
-
         /* use a bounded retrieval of the original input */
         if (i < n_py_args)
-            py_arg_item = PyTuple_GET_ITEM (py_args, i);
+            py_arg_item = py_args[i];
 
         if (kw_arg_item == NULL && py_arg_item != NULL) {
             if (is_varargs_user_data) {
                 /* For tail end user_data varargs, pull a slice off and we are done. */
-                PyObject *user_data = PyTuple_GetSlice (py_args, i, PY_SSIZE_T_MAX);
-                PyTuple_SET_ITEM (combined_py_args, i, user_data);
-                return combined_py_args;
+                Py_ssize_t j;
+                PyObject *user_data = PyTuple_New (n_py_args - i);
+                if (user_data == NULL)
+                    return FALSE;
+
+                for (j = i; j < n_py_args; j++) {
+                    Py_INCREF (py_args[j]);
+                    PyTuple_SET_ITEM (user_data, j - i, py_args[j]);
+                }
+                state->py_user_data_varargs = user_data;
+                combined_py_args[i] = user_data;
+                return TRUE;
             } else {
-                Py_INCREF (py_arg_item);
-                PyTuple_SET_ITEM (combined_py_args, i, py_arg_item);
+                combined_py_args[i] = py_arg_item;
             }
         } else if (kw_arg_item != NULL && py_arg_item == NULL) {
             if (is_varargs_user_data) {
@@ -175,22 +244,27 @@ _py_args_combine_and_check_length (PyGICallableCache *cache,
                  * Wrap the value in a tuple to represent variable args for marshaling later on.
                  */
                 PyObject *user_data = Py_BuildValue("(O)", kw_arg_item, NULL);
-                PyTuple_SET_ITEM (combined_py_args, i, user_data);
+                if (user_data == NULL)
+                    return FALSE;
+                state->py_user_data_varargs = user_data;
+                combined_py_args[i] = user_data;
             } else {
-                Py_INCREF (kw_arg_item);
-                PyTuple_SET_ITEM (combined_py_args, i, kw_arg_item);
+                combined_py_args[i] = kw_arg_item;
             }
 
         } else if (kw_arg_item == NULL && py_arg_item == NULL) {
             if (is_varargs_user_data) {
                 /* For varargs user_data, pass an empty tuple when nothing is given. */
-                PyTuple_SET_ITEM (combined_py_args, i, PyTuple_New (0));
+                PyObject *user_data = PyTuple_New (0);
+                if (user_data == NULL)
+                    return FALSE;
+                state->py_user_data_varargs = user_data;
+                combined_py_args[i] = user_data;
             } else if (arg_cache_index >= 0 && _pygi_callable_cache_get_arg (cache, arg_cache_index)->has_default) {
                 /* If the argument supports a default, use a place holder in the
-                 * argument tuple, this will be checked later during marshaling.
+                 * argument vector, this will be checked later during marshaling.
                  */
-                Py_INCREF (_PyGIDefaultArgPlaceholder);
-                PyTuple_SET_ITEM (combined_py_args, i, _PyGIDefaultArgPlaceholder);
+                combined_py_args[i] = _PyGIDefaultArgPlaceholder;
             } else {
                 char *full_name = pygi_callable_cache_get_full_name (cache);
                 PyErr_Format (PyExc_TypeError,
@@ -201,9 +275,7 @@ _py_args_combine_and_check_length (PyGICallableCache *cache,
                               n_expected_args == 1 ? "" : "s",
                               n_py_args);
                 g_free (full_name);
-
-                Py_DECREF (combined_py_args);
-                return NULL;
+                return FALSE;
             }
         } else if (kw_arg_item != NULL && py_arg_item != NULL) {
             char *full_name = pygi_callable_cache_get_full_name (cache);
@@ -211,28 +283,235 @@ _py_args_combine_and_check_length (PyGICallableCache *cache,
                           "%.200s() got multiple values for keyword argument '%.200s'",
                           full_name,
                           arg_name);
-
-            Py_DECREF (combined_py_args);
             g_free (full_name);
-            return NULL;
+            return FALSE;
         }
     }
 
-    return combined_py_args;
+    return TRUE;
 }
 
-/* To reduce calls to g_slice_*() we (1) allocate all the memory depended on
- * the argument count in one go and (2) keep one version per argument count
- * around for faster reuse.
+/**
+ * pygi_invoke_stack_init:
+ * @stack: PyGIInvokeStack to initialize
+ * @py_bound_arg: (allow-none): argument to prepend to the positional arguments
+ * @py_args: tuple of positional arguments
+ * @py_kwargs: (allow-none): dict of keyword arguments
+ *
+ * Converts the tuple and dict based calling convention into an argument
+ * vector followed by keyword argument values and a tuple of their names.
+ * Unbound calls without keyword arguments reference the items of py_args
+ * directly, otherwise the vector is copied into stack->small_stack when
+ * it fits. Values in the vector are borrowed from py_args and py_kwargs.
+ *
+ * Returns: FALSE with an exception set on failure.
  */
+gboolean
+pygi_invoke_stack_init (PyGIInvokeStack *stack,
+                        PyObject        *py_bound_arg,
+                        PyObject        *py_args,
+                        PyObject        *py_kwargs)
+{
+    Py_ssize_t n_args, n_kwargs, n_offset, i;
+    PyObject **args;
+
+    n_args = PyTuple_GET_SIZE (py_args);
+    n_kwargs = py_kwargs != NULL ? PyDict_Size (py_kwargs) : 0;
+    n_offset = py_bound_arg != NULL ? 1 : 0;
+
+    stack->heap = NULL;
+    stack->kwnames = NULL;
+    stack->n_args = n_args + n_offset;
+
+    if (n_offset == 0 && n_kwargs == 0) {
+        stack->args = &PyTuple_GET_ITEM (py_args, 0);
+        return TRUE;
+    }
+
+    if (n_offset + n_args + n_kwargs <= PYGI_INVOKE_SMALL_STACK) {
+        args = stack->small_stack;
+    } else {
+        args = stack->heap = g_new (PyObject *, n_offset + n_args + n_kwargs);
+    }
+
+    if (py_bound_arg != NULL)
+        args[0] = py_bound_arg;
+
+    for (i = 0; i < n_args; i++)
+        args[n_offset + i] = PyTuple_GET_ITEM (py_args, i);
+
+    if (n_kwargs > 0) {
+        PyObject *key, *value;
+        Py_ssize_t pos = 0;
+
+        stack->kwnames = PyTuple_New (n_kwargs);
+        if (stack->kwnames == NULL) {
+            pygi_invoke_stack_clear (stack);
+            return FALSE;
+        }
 
-#define PyGI_INVOKE_ARG_STATE_SIZE(n)   (n * (sizeof (PyGIInvokeArgState) + sizeof (GIArgument *)))
-#define PyGI_INVOKE_ARG_STATE_N_MAX     10
-static gpointer free_arg_state[PyGI_INVOKE_ARG_STATE_N_MAX];
+        i = 0;
+        while (PyDict_Next (py_kwargs, &pos, &key, &value)) {
+            Py_INCREF (key);
+            PyTuple_SET_ITEM (stack->kwnames, i, key);
+            args[n_offset + n_args + i] = value;
+            i++;
+        }
+    }
+
+    stack->args = args;
+    return TRUE;
+}
+
+/**
+ * pygi_invoke_stack_clear:
+ * Releases memory held by a PyGIInvokeStack setup with pygi_invoke_stack_init.
+ */
+void
+pygi_invoke_stack_clear (PyGIInvokeStack *stack)
+{
+    g_free (stack->heap);
+    stack->heap = NULL;
+    Py_CLEAR (stack->kwnames);
+}
+
+/* The memory depending on the argument count is allocated in one block from
+ * a per-thread stack of chunks. Invocations nest strictly (a callback
+ * invoking another GI function returns before its caller does), so blocks
+ * are released in reverse order of allocation and the chunks are kept
+ * around for reuse. Once a thread reached its maximum nesting depth no
+ * further memory is allocated for invoke states.
+ */
+
+#define PyGI_INVOKE_ARG_STATE_SIZE(n)   (n * (sizeof (PyGIInvokeArgState) + sizeof (GIArgument *) + sizeof (PyObject *)))
+#define PyGI_INVOKE_ARG_STATE_ALIGN(size) \
+    (((size) + sizeof (GIArgument) - 1) & ~(sizeof (GIArgument) - 1))
+#define PyGI_INVOKE_ARG_STATE_CHUNK_SIZE 4096
+
+typedef struct _PyGIArgStateChunk PyGIArgStateChunk;
+struct _PyGIArgStateChunk
+{
+    PyGIArgStateChunk *prev;
+    PyGIArgStateChunk *next;
+    gsize size;
+    gsize used;
+    /* Followed by size bytes of storage. */
+};
+
+#define PyGI_ARG_STATE_CHUNK_DATA(chunk) \
+    ((gchar *)(chunk) + PyGI_INVOKE_ARG_STATE_ALIGN (sizeof (PyGIArgStateChunk)))
+
+static void
+_arg_state_chunks_free (gpointer data)
+{
+    PyGIArgStateChunk *chunk = data;
+
+    while (chunk != NULL && chunk->prev != NULL)
+        chunk = chunk->prev;
+
+    while (chunk != NULL) {
+        PyGIArgStateChunk *next = chunk->next;
+        g_free (chunk);
+        chunk = next;
+    }
+}
+
+/* Points at the chunk currently allocated from. */
+static GPrivate arg_state_current_chunk = G_PRIVATE_INIT (_arg_state_chunks_free);
+
+/* Only updated with the GIL held. */
+static gsize arg_state_hits = 0;
+static gsize arg_state_misses = 0;
+
+static PyGIArgStateChunk *
+_arg_state_chunk_new (PyGIArgStateChunk *prev, gsize min_size)
+{
+    PyGIArgStateChunk *chunk;
+    gsize size = PyGI_INVOKE_ARG_STATE_CHUNK_SIZE;
+
+    if (prev != NULL)
+        size = prev->size * 2;
+    while (size < min_size)
+        size *= 2;
+
+    chunk = g_try_malloc (PyGI_INVOKE_ARG_STATE_ALIGN (sizeof (PyGIArgStateChunk)) + size);
+    if (chunk == NULL)
+        return NULL;
+
+    chunk->prev = prev;
+    chunk->next = NULL;
+    chunk->size = size;
+    chunk->used = 0;
+    if (prev != NULL)
+        prev->next = chunk;
+
+    return chunk;
+}
+
+static gpointer
+_arg_state_push (gsize size)
+{
+    PyGIArgStateChunk *chunk = g_private_get (&arg_state_current_chunk);
+    gpointer mem;
+
+    if (chunk == NULL) {
+        chunk = _arg_state_chunk_new (NULL, size);
+        if (chunk == NULL)
+            return NULL;
+        g_private_set (&arg_state_current_chunk, chunk);
+        arg_state_misses++;
+    } else if (chunk->size - chunk->used < size) {
+        /* Chunks following the current one are unused, replace the next one
+         * if it is too small to hold this block.
+         */
+        PyGIArgStateChunk *next = chunk->next;
+
+        if (next != NULL && next->size < size) {
+            chunk->next = NULL;
+            next->prev = NULL;
+            _arg_state_chunks_free (next);
+            next = NULL;
+        }
+
+        if (next == NULL) {
+            next = _arg_state_chunk_new (chunk, size);
+            if (next == NULL)
+                return NULL;
+            arg_state_misses++;
+        } else {
+            arg_state_hits++;
+        }
+
+        chunk = next;
+        g_private_set (&arg_state_current_chunk, chunk);
+    } else {
+        arg_state_hits++;
+    }
+
+    mem = PyGI_ARG_STATE_CHUNK_DATA (chunk) + chunk->used;
+    chunk->used += size;
+    memset (mem, 0, size);
+
+    return mem;
+}
+
+static void
+_arg_state_pop (gpointer mem, gsize size)
+{
+    PyGIArgStateChunk *chunk = g_private_get (&arg_state_current_chunk);
+
+    g_assert (chunk != NULL && chunk->used >= size);
+    g_assert ((gchar *)mem == PyGI_ARG_STATE_CHUNK_DATA (chunk) + chunk->used - size);
+
+    chunk->used -= size;
+    if (chunk->used == 0 && chunk->prev != NULL)
+        g_private_set (&arg_state_current_chunk, chunk->prev);
+}
 
 /**
  * _pygi_invoke_arg_state_init:
- * Sets PyGIInvokeState.args and PyGIInvokeState.ffi_args.
+ * Sets PyGIInvokeState.args, PyGIInvokeState.ffi_args and
+ * PyGIInvokeState.py_in_args_buffer.
  * On error returns FALSE and sets an exception.
  */
 gboolean
@@ -240,22 +519,22 @@ _pygi_invoke_arg_state_init (PyGIInvokeState *state) {
 
     gpointer mem;
 
-    if (state->n_args < PyGI_INVOKE_ARG_STATE_N_MAX && (mem = free_arg_state[state->n_args]) != NULL) {
-        free_arg_state[state->n_args] = NULL;
-        memset (mem, 0, PyGI_INVOKE_ARG_STATE_SIZE (state->n_args));
-    } else {
-        mem = g_slice_alloc0 (PyGI_INVOKE_ARG_STATE_SIZE (state->n_args));
+    if (state->n_args == 0) {
+        state->args = NULL;
+        state->ffi_args = NULL;
+        state->py_in_args_buffer = NULL;
+        return TRUE;
     }
 
-    if (mem == NULL && state->n_args != 0) {
+    mem = _arg_state_push (PyGI_INVOKE_ARG_STATE_ALIGN (PyGI_INVOKE_ARG_STATE_SIZE (state->n_args)));
+    if (mem == NULL) {
         PyErr_NoMemory();
         return FALSE;
     }
 
-    if (mem != NULL) {
-        state->args = mem;
-        state->ffi_args = (gpointer)((gchar *)mem + state->n_args * sizeof (PyGIInvokeArgState));
-    }
+    state->args = mem;
+    state->ffi_args = (gpointer)((gchar *)mem + state->n_args * sizeof (PyGIInvokeArgState));
+    state->py_in_args_buffer = (gpointer)((gchar *)state->ffi_args + state->n_args * sizeof (GIArgument *));
 
     return TRUE;
 }
@@ -266,19 +545,32 @@ _pygi_invoke_arg_state_init (PyGIInvokeState *state) {
  */
 void
 _pygi_invoke_arg_state_free(PyGIInvokeState *state) {
-    if (state->n_args < PyGI_INVOKE_ARG_STATE_N_MAX && free_arg_state[state->n_args] == NULL) {
-        free_arg_state[state->n_args] = state->args;
+    if (state->args == NULL)
         return;
-    }
 
-    g_slice_free1 (PyGI_INVOKE_ARG_STATE_SIZE (state->n_args), state->args);
+    _arg_state_pop (state->args,
+                    PyGI_INVOKE_ARG_STATE_ALIGN (PyGI_INVOKE_ARG_STATE_SIZE (state->n_args)));
+    state->args = NULL;
+}
+
+/**
+ * _pygi_invoke_arg_state_stats:
+ * @hits: (out): number of blocks served from already allocated memory
+ * @misses: (out): number of blocks which required allocating a new chunk
+ */
+void
+_pygi_invoke_arg_state_stats (gsize *hits, gsize *misses)
+{
+    *hits = arg_state_hits;
+    *misses = arg_state_misses;
 }
 
 static gboolean
 _invoke_state_init_from_cache (PyGIInvokeState *state,
                                PyGIFunctionCache *function_cache,
-                               PyObject *py_args,
-                               PyObject *kwargs)
+                               PyObject *const *py_args,
+                               Py_ssize_t py_nargs,
+                               PyObject *py_kwnames)
 {
     PyGICallableCache *cache = (PyGICallableCache *) function_cache;
 
@@ -294,16 +586,15 @@ _invoke_state_init_from_cache (PyGIInvokeState *state,
     if (state->function_ptr == NULL)
         state->function_ptr = function_cache->invoker.native_address;
 
-    state->py_in_args = _py_args_combine_and_check_length (cache,
-                                                           py_args,
-                                                           kwargs);
-
-    if (state->py_in_args == NULL) {
+    if (!_pygi_invoke_arg_state_init (state)) {
         return FALSE;
     }
-    state->n_py_in_args = PyTuple_Size (state->py_in_args);
 
-    if (!_pygi_invoke_arg_state_init (state)) {
+    if (!_py_args_combine_and_check_length (state,
+                                            cache,
+                                            py_args,
+                                            py_nargs,
+                                            py_kwnames)) {
         return FALSE;
     }
 
@@ -323,7 +614,7 @@ static void
 _invoke_state_clear (PyGIInvokeState *state, PyGIFunctionCache *function_cache)
 {
     _pygi_invoke_arg_state_free (state);
-    Py_XDECREF (state->py_in_args);
+    Py_XDECREF (state->py_user_data_varargs);
 }
 
 static gboolean
@@ -337,7 +628,7 @@ _caller_alloc (PyGIArgCache *arg_cache, GIArgument *arg)
             arg->v_pointer =
                 _pygi_boxed_alloc (iface_cache->interface_info, NULL);
         } else if (iface_cache->g_type == G_TYPE_VALUE) {
-            arg->v_pointer = g_slice_new0 (GValue);
+            arg->v_pointer = _pygi_boxed_slice_alloc0 (sizeof (GValue));
         } else if (iface_cache->is_foreign) {
             PyObject *foreign_struct =
                 pygi_struct_foreign_convert_from_g_argument (
@@ -369,7 +660,245 @@ _caller_alloc (PyGIArgCache *arg_cache, GIArgument *arg)
     return TRUE;
 }
 
-/* pygi_invoke_marshal_in_args:
+/* Sets the TypeError for calls with the wrong number of arguments. */
+static void
+_invoke_set_arg_count_error (PyGIInvokeState *state, PyGICallableCache *cache)
+{
+    char *full_name = pygi_callable_cache_get_full_name (cache);
+    PyErr_Format (PyExc_TypeError,
+                  "%s() takes exactly %zd argument(s) (%zd given)",
+                  full_name,
+                  cache->n_py_args,
+                  state->n_py_in_args);
+    g_free (full_name);
+}
+
+/* _marshal_from_py_scalar:
+ *
+ * Converts the exact int, bool and float objects without going through the
+ * number protocol. Returns FALSE without an exception set for anything else
+ * (including values out of range) which then goes the generic way to get
+ * the same conversions and error messages.
+ */
+static inline gboolean
+_marshal_from_py_scalar (PyObject *py_arg, GIArgument *arg, GITypeTag type_tag)
+{
+    long value;
+
+    switch (type_tag) {
+        case GI_TYPE_TAG_BOOLEAN:
+            if (py_arg == Py_True) {
+                arg->v_boolean = TRUE;
+                return TRUE;
+            } else if (py_arg == Py_False) {
+                arg->v_boolean = FALSE;
+                return TRUE;
+            }
+            return FALSE;
+        case GI_TYPE_TAG_DOUBLE:
+            if (!PyFloat_CheckExact (py_arg))
+                return FALSE;
+            arg->v_double = PyFloat_AS_DOUBLE (py_arg);
+            return TRUE;
+        case GI_TYPE_TAG_FLOAT:
+            if (!PyFloat_CheckExact (py_arg) ||
+                    PyFloat_AS_DOUBLE (py_arg) < -G_MAXFLOAT ||
+                    PyFloat_AS_DOUBLE (py_arg) > G_MAXFLOAT)
+                return FALSE;
+            arg->v_float = PyFloat_AS_DOUBLE (py_arg);
+            return TRUE;
+        default:
+            break;
+    }
+
+#if PY_VERSION_HEX < 0x03000000
+    if (!PyInt_CheckExact (py_arg))
+        return FALSE;
+    value = PyInt_AS_LONG (py_arg);
+#else
+    {
+        int overflow;
+
+        if (!PyLong_CheckExact (py_arg))
+            return FALSE;
+        value = PyLong_AsLongAndOverflow (py_arg, &overflow);
+        if (overflow != 0)
+            return FALSE;
+    }
+#endif
+
+    switch (type_tag) {
+        case GI_TYPE_TAG_INT8:
+            if (value < G_MININT8 || value > G_MAXINT8)
+                return FALSE;
+            arg->v_int8 = value;
+            return TRUE;
+        case GI_TYPE_TAG_UINT8:
+            if (value < 0 || value > G_MAXUINT8)
+                return FALSE;
+            arg->v_uint8 = value;
+            return TRUE;
+        case GI_TYPE_TAG_INT16:
+            if (value < G_MININT16 || value > G_MAXINT16)
+                return FALSE;
+            arg->v_int16 = value;
+            return TRUE;
+        case GI_TYPE_TAG_UINT16:
+            if (value < 0 || value > G_MAXUINT16)
+                return FALSE;
+            arg->v_uint16 = value;
+            return TRUE;
+        case GI_TYPE_TAG_INT32:
+            if (value < G_MININT32 || value > G_MAXINT32)
+                return FALSE;
+            arg->v_int32 = value;
+            return TRUE;
+        case GI_TYPE_TAG_UINT32:
+            if (value < 0 || (unsigned long) value > G_MAXUINT32)
+                return FALSE;
+            arg->v_uint32 = value;
+            return TRUE;
+        case GI_TYPE_TAG_INT64:
+            arg->v_int64 = value;
+            return TRUE;
+        case GI_TYPE_TAG_UINT64:
+            if (value < 0)
+                return FALSE;
+            arg->v_uint64 = value;
+            return TRUE;
+        default:
+            return FALSE;
+    }
+}
+
+/* _invoke_marshal_in_arg:
+ *
+ * Marshals argument @i through the marshallers of its argument cache,
+ * used for the arguments the marshal plan has no specific step for.
+ */
+static gboolean
+_invoke_marshal_in_arg (PyGIInvokeState *state, PyGICallableCache *cache, gssize i)
+{
+    GIArgument *c_arg = &state->args[i].arg_value;
+    PyGIArgCache *arg_cache = g_ptr_array_index (cache->args_cache, i);
+    PyObject *py_arg = NULL;
+
+    switch (arg_cache->direction) {
+        case PYGI_DIRECTION_FROM_PYTHON:
+            /* The ffi argument points directly at memory in arg_values. */
+            state->ffi_args[i] = c_arg;
+
+            if (arg_cache->meta_type == PYGI_META_ARG_TYPE_CLOSURE) {
+                state->ffi_args[i]->v_pointer = state->user_data;
+                return TRUE;
+            } else if (arg_cache->meta_type != PYGI_META_ARG_TYPE_PARENT)
+                return TRUE;
+
+            if (arg_cache->py_arg_index >= state->n_py_in_args) {
+                _invoke_set_arg_count_error (state, cache);
+
+                /* clean up all of the args we have already marshalled,
+                 * since invoke will not be called
+                 */
+                pygi_marshal_cleanup_args_from_py_parameter_fail (state,
+                                                                  cache,
+                                                                  i);
+                return FALSE;
+            }
+
+            py_arg = state->py_in_args[arg_cache->py_arg_index];
+
+            break;
+        case PYGI_DIRECTION_BIDIRECTIONAL:
+            if (arg_cache->meta_type != PYGI_META_ARG_TYPE_CHILD) {
+                if (arg_cache->py_arg_index >= state->n_py_in_args) {
+                    _invoke_set_arg_count_error (state, cache);
+                    pygi_marshal_cleanup_args_from_py_parameter_fail (state,
+                                                                      cache,
+                                                                      i);
+                    return FALSE;
+                }
+
+                py_arg = state->py_in_args[arg_cache->py_arg_index];
+            }
+            /* Fall through */
+
+        case PYGI_DIRECTION_TO_PYTHON:
+            /* arg_pointers always stores a pointer to the data to be marshaled "to python"
+             * even in cases where arg_pointers is not being used as indirection between
+             * ffi and arg_values. This gives a guarantee that out argument marshaling
+             * (_invoke_marshal_out_args) can always rely on arg_pointers pointing to
+             * the correct chunk of memory to marshal.
+             */
+            state->args[i].arg_pointer.v_pointer = c_arg;
+
+            if (arg_cache->is_caller_allocates) {
+                /* In the case of caller allocated out args, we don't use
+                 * an extra level of indirection and state->args will point
+                 * directly at the data to be marshaled. However, as noted
+                 * above, arg_pointers will also point to this caller allocated
+                 * chunk of memory used by out argument marshaling.
+                 */
+                state->ffi_args[i] = c_arg;
+
+                if (!_caller_alloc (arg_cache, c_arg)) {
+                    char *full_name = pygi_callable_cache_get_full_name (cache);
+                    PyErr_Format (PyExc_TypeError,
+                                  "Could not caller allocate argument %zd of callable %s",
+                                  i, full_name);
+                    g_free (full_name);
+                    pygi_marshal_cleanup_args_from_py_parameter_fail (state,
+                                                                      cache,
+                                                                      i);
+                    return FALSE;
+                }
+            } else {
+                /* Non-caller allocated out args will use arg_pointers as an
+                 * extra level of indirection */
+                state->ffi_args[i] = &state->args[i].arg_pointer;
+            }
+
+            break;
+    }
+
+    if (py_arg == _PyGIDefaultArgPlaceholder) {
+        *c_arg = arg_cache->default_value;
+    } else if (arg_cache->from_py_marshaller != NULL &&
+               arg_cache->meta_type != PYGI_META_ARG_TYPE_CHILD) {
+        gboolean success;
+        gpointer cleanup_data = NULL;
+
+        if (!arg_cache->allow_none && py_arg == Py_None) {
+            PyErr_Format (PyExc_TypeError,
+                          "Argument %zd does not allow None as a value",
+                          i);
+
+             pygi_marshal_cleanup_args_from_py_parameter_fail (state,
+                                                               cache,
+                                                               i);
+             return FALSE;
+        }
+        success = arg_cache->from_py_marshaller (state,
+                                                 cache,
+                                                 arg_cache,
+                                                 py_arg,
+                                                 c_arg,
+                                                 &cleanup_data);
+        state->args[i].arg_cleanup_data = cleanup_data;
+
+        if (!success) {
+            pygi_marshal_cleanup_args_from_py_parameter_fail (state,
+                                                              cache,
+                                                              i);
+            return FALSE;
+        }
+
+    }
+
+    return TRUE;
+}
+
+/* _invoke_marshal_in_args:
  *
  * Fills out the state struct argument lists. arg_values will always hold
  * actual values marshaled either to or from Python and C. arg_pointers will
@@ -378,7 +907,7 @@ _caller_alloc (PyGIArgCache *arg_cache, GIArgument *arg)
  * out args, arg_pointers[x].v_pointer will point to newly allocated memory.
  * arg_pointers inserts a level of pointer indirection between arg_values
  * and the argument list ffi receives when dealing with non-caller allocated
- * out arguments.
+ * out args.
  *
  * For example:
  * [[
@@ -396,162 +925,97 @@ _caller_alloc (PyGIArgCache *arg_cache, GIArgument *arg)
  *  arg_values[1].v_int == 8;
  * ]]
  *
+ * The steps of the cache's marshal plan handle the simple arguments inline,
+ * everything else goes through _invoke_marshal_in_arg().
  */
 static gboolean
 _invoke_marshal_in_args (PyGIInvokeState *state, PyGIFunctionCache *function_cache)
 {
     PyGICallableCache *cache = (PyGICallableCache *) function_cache;
-    gssize i;
+    const PyGIMarshalStep *step = cache->in_plan;
+    gssize i, n_args = _pygi_callable_cache_args_len (cache);
 
     if (state->n_py_in_args > cache->n_py_args) {
-        char *full_name = pygi_callable_cache_get_full_name (cache);
-        PyErr_Format (PyExc_TypeError,
-                      "%s() takes exactly %zd argument(s) (%zd given)",
-                      full_name,
-                      cache->n_py_args,
-                      state->n_py_in_args);
-        g_free (full_name);
+        _invoke_set_arg_count_error (state, cache);
         return FALSE;
     }
 
-    for (i = 0; i < _pygi_callable_cache_args_len (cache); i++) {
+    for (i = 0; i < n_args; i++, step++) {
         GIArgument *c_arg = &state->args[i].arg_value;
-        PyGIArgCache *arg_cache = g_ptr_array_index (cache->args_cache, i);
-        PyObject *py_arg = NULL;
+        PyObject *py_arg;
 
-        switch (arg_cache->direction) {
-            case PYGI_DIRECTION_FROM_PYTHON:
-                /* The ffi argument points directly at memory in arg_values. */
+        switch (step->op) {
+            case PYGI_MARSHAL_OP_IN_CLOSURE:
+                state->ffi_args[i] = c_arg;
+                c_arg->v_pointer = state->user_data;
+                break;
+            case PYGI_MARSHAL_OP_IN_CHILD:
+                state->ffi_args[i] = c_arg;
+                break;
+            case PYGI_MARSHAL_OP_OUT:
+                state->args[i].arg_pointer.v_pointer = c_arg;
+                state->ffi_args[i] = &state->args[i].arg_pointer;
+                break;
+            case PYGI_MARSHAL_OP_IN_BASIC:
                 state->ffi_args[i] = c_arg;
 
-                if (arg_cache->meta_type == PYGI_META_ARG_TYPE_CLOSURE) {
-                    state->ffi_args[i]->v_pointer = state->user_data;
-                    continue;
-                } else if (arg_cache->meta_type != PYGI_META_ARG_TYPE_PARENT)
-                    continue;
-
-                if (arg_cache->py_arg_index >= state->n_py_in_args) {
-                    char *full_name = pygi_callable_cache_get_full_name (cache);
-                    PyErr_Format (PyExc_TypeError,
-                                  "%s() takes exactly %zd argument(s) (%zd given)",
-                                   full_name,
-                                   cache->n_py_args,
-                                   state->n_py_in_args);
-                    g_free (full_name);
-
-                    /* clean up all of the args we have already marshalled,
-                     * since invoke will not be called
-                     */
+                if (step->index >= state->n_py_in_args) {
+                    _invoke_set_arg_count_error (state, cache);
                     pygi_marshal_cleanup_args_from_py_parameter_fail (state,
                                                                       cache,
                                                                       i);
                     return FALSE;
                 }
 
-                py_arg =
-                    PyTuple_GET_ITEM (state->py_in_args,
-                                      arg_cache->py_arg_index);
+                py_arg = state->py_in_args[step->index];
+                if (_marshal_from_py_scalar (py_arg, c_arg, step->type_tag))
+                    break;
 
-                break;
-            case PYGI_DIRECTION_BIDIRECTIONAL:
-                if (arg_cache->meta_type != PYGI_META_ARG_TYPE_CHILD) {
-                    if (arg_cache->py_arg_index >= state->n_py_in_args) {
-                        char *full_name = pygi_callable_cache_get_full_name (cache);
-                        PyErr_Format (PyExc_TypeError,
-                                      "%s() takes exactly %zd argument(s) (%zd given)",
-                                       full_name,
-                                       cache->n_py_args,
-                                       state->n_py_in_args);
-                        g_free (full_name);
-                        pygi_marshal_cleanup_args_from_py_parameter_fail (state,
-                                                                          cache,
-                                                                          i);
-                        return FALSE;
-                    }
-
-                    py_arg =
-                        PyTuple_GET_ITEM (state->py_in_args,
-                                          arg_cache->py_arg_index);
+                if (py_arg == _PyGIDefaultArgPlaceholder) {
+                    *c_arg = step->arg_cache->default_value;
+                    break;
                 }
-                /* Fall through */
-
-            case PYGI_DIRECTION_TO_PYTHON:
-                /* arg_pointers always stores a pointer to the data to be marshaled "to python"
-                 * even in cases where arg_pointers is not being used as indirection between
-                 * ffi and arg_values. This gives a guarantee that out argument marshaling
-                 * (_invoke_marshal_out_args) can always rely on arg_pointers pointing to
-                 * the correct chunk of memory to marshal.
-                 */
-                state->args[i].arg_pointer.v_pointer = c_arg;
 
-                if (arg_cache->is_caller_allocates) {
-                    /* In the case of caller allocated out args, we don't use
-                     * an extra level of indirection and state->args will point
-                     * directly at the data to be marshaled. However, as noted
-                     * above, arg_pointers will also point to this caller allocated
-                     * chunk of memory used by out argument marshaling.
-                     */
-                    state->ffi_args[i] = c_arg;
-
-                    if (!_caller_alloc (arg_cache, c_arg)) {
-                        char *full_name = pygi_callable_cache_get_full_name (cache);
-                        PyErr_Format (PyExc_TypeError,
-                                      "Could not caller allocate argument %zd of callable %s",
-                                      i, full_name);
-                        g_free (full_name);
-                        pygi_marshal_cleanup_args_from_py_parameter_fail (state,
-                                                                          cache,
-                                                                          i);
-                        return FALSE;
-                    }
-                } else {
-                    /* Non-caller allocated out args will use arg_pointers as an
-                     * extra level of indirection */
-                    state->ffi_args[i] = &state->args[i].arg_pointer;
+                if (!step->arg_cache->allow_none && py_arg == Py_None) {
+                    PyErr_Format (PyExc_TypeError,
+                                  "Argument %zd does not allow None as a value",
+                                  i);
+                    pygi_marshal_cleanup_args_from_py_parameter_fail (state,
+                                                                      cache,
+                                                                      i);
+                    return FALSE;
                 }
 
+                if (!_pygi_marshal_from_py_basic_type (py_arg, c_arg,
+                                                       step->type_tag,
+                                                       step->transfer,
+                                                       &state->args[i].arg_cleanup_data)) {
+                    pygi_marshal_cleanup_args_from_py_parameter_fail (state,
+                                                                      cache,
+                                                                      i);
+                    return FALSE;
+                }
+                break;
+            default:
+                if (!_invoke_marshal_in_arg (state, cache, i))
+                    return FALSE;
                 break;
         }
-
-        if (py_arg == _PyGIDefaultArgPlaceholder) {
-            *c_arg = arg_cache->default_value;
-        } else if (arg_cache->from_py_marshaller != NULL &&
-                   arg_cache->meta_type != PYGI_META_ARG_TYPE_CHILD) {
-            gboolean success;
-            gpointer cleanup_data = NULL;
-
-            if (!arg_cache->allow_none && py_arg == Py_None) {
-                PyErr_Format (PyExc_TypeError,
-                              "Argument %zd does not allow None as a value",
-                              i);
-
-                 pygi_marshal_cleanup_args_from_py_parameter_fail (state,
-                                                                   cache,
-                                                                   i);
-                 return FALSE;
-            }
-            success = arg_cache->from_py_marshaller (state,
-                                                     cache,
-                                                     arg_cache,
-                                                     py_arg,
-                                                     c_arg,
-                                                     &cleanup_data);
-            state->args[i].arg_cleanup_data = cleanup_data;
-
-            if (!success) {
-                pygi_marshal_cleanup_args_from_py_parameter_fail (state,
-                                                                  cache,
-                                                                  i);
-                return FALSE;
-            }
-
-        }
-
     }
 
     return TRUE;
 }
 
+static inline PyObject *
+_invoke_marshal_out_step (PyGIInvokeState *state, PyGICallableCache *cache,
+                          const PyGIMarshalStep *step, GIArgument *arg)
+{
+    if (step->op == PYGI_MARSHAL_OP_TO_PY_BASIC)
+        return _pygi_marshal_to_py_basic_type (arg, step->type_tag, step->transfer);
+
+    return step->arg_cache->to_py_marshaller (state, cache, step->arg_cache, arg);
+}
+
 static PyObject *
 _invoke_marshal_out_args (PyGIInvokeState *state, PyGIFunctionCache *function_cache)
 {
@@ -562,10 +1026,10 @@ _invoke_marshal_out_args (PyGIInvokeState *state, PyGIFunctionCache *function_ca
 
     if (cache->return_cache) {
         if (!cache->return_cache->is_skipped) {
-            py_return = cache->return_cache->to_py_marshaller ( state,
-                                                                cache,
-                                                                cache->return_cache,
-                                                               &state->return_arg);
+            py_return = _invoke_marshal_out_step (state,
+                                                  cache,
+                                                  &cache->return_step,
+                                                  &state->return_arg);
             if (py_return == NULL) {
                 pygi_marshal_cleanup_args_return_fail (state,
                                                        cache);
@@ -600,11 +1064,11 @@ _invoke_marshal_out_args (PyGIInvokeState *state, PyGIFunctionCache *function_ca
         py_out = py_return;
     } else if (!cache->has_return && n_out_args == 1) {
         /* if we get here there is one out arg an no return */
-        PyGIArgCache *arg_cache = (PyGIArgCache *)cache->to_py_args->data;
-        py_out = arg_cache->to_py_marshaller (state,
-                                              cache,
-                                              arg_cache,
-                                              state->args[arg_cache->c_arg_index].arg_pointer.v_pointer);
+        const PyGIMarshalStep *step = cache->to_py_plan;
+        py_out = _invoke_marshal_out_step (state,
+                                           cache,
+                                           step,
+                                           state->args[step->index].arg_pointer.v_pointer);
         if (py_out == NULL) {
             pygi_marshal_cleanup_args_to_py_parameter_fail (state,
                                                             cache,
@@ -615,7 +1079,7 @@ _invoke_marshal_out_args (PyGIInvokeState *state, PyGIFunctionCache *function_ca
     } else {
         /* return a tuple */
         gssize py_arg_index = 0;
-        GSList *cache_item = cache->to_py_args;
+        const PyGIMarshalStep *step = cache->to_py_plan;
         gssize tuple_len = cache->has_return + n_out_args;
 
         py_out = pygi_resulttuple_new (cache->resulttuple_type, tuple_len);
@@ -633,11 +1097,10 @@ _invoke_marshal_out_args (PyGIInvokeState *state, PyGIFunctionCache *function_ca
         }
 
         for (; py_arg_index < tuple_len; py_arg_index++) {
-            PyGIArgCache *arg_cache = (PyGIArgCache *)cache_item->data;
-            PyObject *py_obj = arg_cache->to_py_marshaller (state,
-                                                            cache,
-                                                            arg_cache,
-                                                            state->args[arg_cache->c_arg_index].arg_pointer.v_pointer);
+            PyObject *py_obj = _invoke_marshal_out_step (state,
+                                                         cache,
+                                                         step,
+                                                         state->args[step->index].arg_pointer.v_pointer);
 
             if (py_obj == NULL) {
                 if (cache->has_return)
@@ -651,37 +1114,40 @@ _invoke_marshal_out_args (PyGIInvokeState *state, PyGIFunctionCache *function_ca
             }
 
             PyTuple_SET_ITEM (py_out, py_arg_index, py_obj);
-            cache_item = cache_item->next;
+            step++;
         }
     }
     return py_out;
 }
 
-PyObject *
-pygi_invoke_c_callable (PyGIFunctionCache *function_cache,
-                        PyGIInvokeState *state,
-                        PyObject *py_args,
-                        PyObject *py_kwargs)
+static inline void
+_invoke_ffi_call (PyGIFunctionCache *function_cache,
+                  PyGIInvokeState *state,
+                  GIFFIReturnValue *ffi_return_value)
 {
-    PyGICallableCache *cache = (PyGICallableCache *) function_cache;
-    GIFFIReturnValue ffi_return_value = {0};
-    PyObject *ret = NULL;
-
-    if (!_invoke_state_init_from_cache (state, function_cache,
-                                        py_args, py_kwargs))
-         goto err;
-
-    if (!_invoke_marshal_in_args (state, function_cache))
-         goto err;
-
-    Py_BEGIN_ALLOW_THREADS;
-
+    if (function_cache->direct_call != NULL) {
+        function_cache->direct_call (state->function_ptr,
+                                     state->ffi_args,
+                                     ffi_return_value);
+    } else {
         ffi_call (&function_cache->invoker.cif,
                   state->function_ptr,
-                  (void *) &ffi_return_value,
+                  (void *) ffi_return_value,
                   (void **) state->ffi_args);
+    }
+}
 
-    Py_END_ALLOW_THREADS;
+/* _invoke_finish_out:
+ *
+ * Marshals the results of the call back to Python, the arguments still
+ * need to be cleaned up with _invoke_finish_cleanup().
+ */
+static inline PyObject *
+_invoke_finish_out (PyGIInvokeState *state,
+                    PyGIFunctionCache *function_cache,
+                    GIFFIReturnValue *ffi_return_value)
+{
+    PyGICallableCache *cache = (PyGICallableCache *) function_cache;
 
     /* If the callable throws, the address of state->error will be bound into
      * the state->args as the last value. When the callee sets an error using
@@ -689,43 +1155,440 @@ pygi_invoke_c_callable (PyGIFunctionCache *function_cache,
      * state->error allowing for easy checking here.
      */
     if (state->error != NULL) {
-        if (pygi_error_check (&state->error)) {
-            /* even though we errored out, the call itself was successful,
-               so we assume the call processed all of the parameters */
-            pygi_marshal_cleanup_args_from_py_marshal_success (state, cache);
-            goto err;
-        }
+        /* even though we errored out, the call itself was successful,
+           so we assume the call processed all of the parameters */
+        if (pygi_error_check (&state->error))
+            return NULL;
     }
 
     if (cache->return_cache) {
         gi_type_info_extract_ffi_return_value (cache->return_cache->type_info,
-                                               &ffi_return_value,
+                                               ffi_return_value,
                                                &state->return_arg);
     }
 
-    ret = _invoke_marshal_out_args (state, function_cache);
+    return _invoke_marshal_out_args (state, function_cache);
+}
+
+static inline void
+_invoke_finish_cleanup (PyGIInvokeState *state,
+                        PyGIFunctionCache *function_cache,
+                        PyObject *ret)
+{
+    PyGICallableCache *cache = (PyGICallableCache *) function_cache;
+
     pygi_marshal_cleanup_args_from_py_marshal_success (state, cache);
 
     if (ret != NULL)
         pygi_marshal_cleanup_args_to_py_marshal_success (state, cache);
+}
+
+/* _invoke_finish:
+ *
+ * Handles the outcome of the C call for a state prepared with
+ * _invoke_state_init_from_cache() and _invoke_marshal_in_args().
+ *
+ * Returns: new reference to the result or NULL with an exception set.
+ */
+static PyObject *
+_invoke_finish (PyGIInvokeState *state,
+                PyGIFunctionCache *function_cache,
+                GIFFIReturnValue *ffi_return_value)
+{
+    PyObject *ret;
+
+    ret = _invoke_finish_out (state, function_cache, ffi_return_value);
+    _invoke_finish_cleanup (state, function_cache, ret);
+
+    return ret;
+}
+
+/* _invoke_c_callable_profiled:
+ *
+ * Same as pygi_invoke_c_callable() but records the time spent in the
+ * different stages of the call while the profiler is enabled.
+ */
+static PyObject *
+_invoke_c_callable_profiled (PyGIFunctionCache *function_cache,
+                             PyGIInvokeState *state,
+                             PyObject *const *py_args,
+                             Py_ssize_t py_nargs,
+                             PyObject *py_kwnames)
+{
+    PyGIProfileStats *stats;
+    GIFFIReturnValue ffi_return_value = {0};
+    PyObject *ret = NULL;
+    gint64 start, in_end, ffi_end = 0, out_end = 0;
+
+    stats = pygi_callable_cache_get_profile_stats ((PyGICallableCache *) function_cache);
+    stats->calls++;
+
+    start = pygi_profiler_now ();
+
+    if (!_invoke_state_init_from_cache (state, function_cache,
+                                        py_args, py_nargs, py_kwnames) ||
+            !_invoke_marshal_in_args (state, function_cache)) {
+        in_end = pygi_profiler_now ();
+        goto err;
+    }
+
+    in_end = pygi_profiler_now ();
+
+    if (function_cache->release_gil) {
+        Py_BEGIN_ALLOW_THREADS;
+
+            _invoke_ffi_call (function_cache, state, &ffi_return_value);
+
+        Py_END_ALLOW_THREADS;
+    } else {
+        _invoke_ffi_call (function_cache, state, &ffi_return_value);
+    }
+
+    ffi_end = pygi_profiler_now ();
+    ret = _invoke_finish_out (state, function_cache, &ffi_return_value);
+    out_end = pygi_profiler_now ();
+
+    _invoke_finish_cleanup (state, function_cache, ret);
 
 err:
     _invoke_state_clear (state, function_cache);
+
+    stats->in_marshal_time += in_end - start;
+    if (ffi_end != 0) {
+        stats->ffi_call_time += ffi_end - in_end;
+        stats->out_marshal_time += out_end - ffi_end;
+        stats->cleanup_time += pygi_profiler_now () - out_end;
+    }
+
     return ret;
 }
 
+/**
+ * pygi_invoke_c_callable:
+ * @function_cache: cache of the callable to invoke
+ * @state: zero initialized invoke state
+ * @py_args: vector of positional arguments followed by the values of the
+ *     keyword arguments named in py_kwnames
+ * @py_nargs: number of positional arguments in py_args
+ * @py_kwnames: (allow-none): tuple of keyword argument names
+ *
+ * Marshals the arguments straight from the given vector, calls the C
+ * function and marshals the results back to Python.
+ *
+ * Returns: new reference to the result or NULL with an exception set.
+ */
 PyObject *
-pygi_callable_info_invoke (GIBaseInfo *info, PyObject *py_args,
-                           PyObject *kwargs, PyGICallableCache *cache,
-                           gpointer user_data)
+pygi_invoke_c_callable (PyGIFunctionCache *function_cache,
+                        PyGIInvokeState *state,
+                        PyObject *const *py_args,
+                        Py_ssize_t py_nargs,
+                        PyObject *py_kwnames)
 {
-    return pygi_function_cache_invoke ((PyGIFunctionCache *) cache,
-                                       py_args, kwargs);
+    GIFFIReturnValue ffi_return_value = {0};
+    PyObject *ret = NULL;
+
+    if (PYGI_PROFILER_IS_ENABLED ())
+        return _invoke_c_callable_profiled (function_cache, state,
+                                            py_args, py_nargs, py_kwnames);
+
+    if (!_invoke_state_init_from_cache (state, function_cache,
+                                        py_args, py_nargs, py_kwnames))
+         goto err;
+
+    if (!_invoke_marshal_in_args (state, function_cache))
+         goto err;
+
+    if (function_cache->release_gil) {
+        Py_BEGIN_ALLOW_THREADS;
+
+            _invoke_ffi_call (function_cache, state, &ffi_return_value);
+
+        Py_END_ALLOW_THREADS;
+    } else {
+        _invoke_ffi_call (function_cache, state, &ffi_return_value);
+    }
+
+    ret = _invoke_finish (state, function_cache, &ffi_return_value);
+
+err:
+    _invoke_state_clear (state, function_cache);
+    return ret;
 }
 
+#define PYGI_INVOKE_MANY_BATCH_SIZE 64
+
+/* _invoke_many_can_batch:
+ *
+ * Calls can be batched when nothing but the arguments is needed to
+ * prepare them and the arguments stay owned by the caller: no transfer of
+ * ownership and no callbacks which could run while other calls of the
+ * batch are pending. CHILD_WITH_PYARG args are callback user data, which
+ * may collect varargs into state->py_user_data_varargs that the callback
+ * needs to outlive the call. Caller allocated out args are excluded as
+ * well, as their storage is only released by marshaling them to Python,
+ * so it would leak for the calls of a batch discarded when a later item
+ * fails to marshal.
+ */
+static gboolean
+_invoke_many_can_batch (PyGIFunctionCache *function_cache)
+{
+    PyGICallableCache *cache = (PyGICallableCache *) function_cache;
+    guint i;
+
+    if (!pygi_function_cache_invokes_directly (function_cache) ||
+            cache->user_data_index >= 0)
+        return FALSE;
+
+    for (i = 0; i < _pygi_callable_cache_args_len (cache); i++) {
+        PyGIArgCache *arg_cache = _pygi_callable_cache_get_arg (cache, i);
+
+        if (arg_cache->meta_type == PYGI_META_ARG_TYPE_CLOSURE ||
+                arg_cache->meta_type == PYGI_META_ARG_TYPE_CHILD_WITH_PYARG)
+            return FALSE;
+
+        if (arg_cache->is_caller_allocates)
+            return FALSE;
+
+        if (!(arg_cache->direction & PYGI_DIRECTION_FROM_PYTHON))
+            continue;
+
+        if (arg_cache->transfer != GI_TRANSFER_NOTHING)
+            return FALSE;
+
+        if (arg_cache->type_tag == GI_TYPE_TAG_INTERFACE &&
+                g_base_info_get_type (((PyGIInterfaceCache *) arg_cache)->interface_info) == GI_INFO_TYPE_CALLBACK)
+            return FALSE;
+    }
+
+    return TRUE;
+}
+
+/* _invoke_many_get_args:
+ *
+ * Returns: new reference to a tuple holding @py_bound_arg (if not NULL)
+ *     followed by the items of @py_item.
+ */
+static PyObject *
+_invoke_many_get_args (PyObject *py_bound_arg, PyObject *py_item)
+{
+    PyObject *py_args;
+    Py_ssize_t i, n_items;
+
+    if (py_bound_arg == NULL)
+        return PySequence_Tuple (py_item);
+
+    py_item = PySequence_Fast (py_item, "invoke_many() arguments must be sequences");
+    if (py_item == NULL)
+        return NULL;
+
+    n_items = PySequence_Fast_GET_SIZE (py_item);
+    py_args = PyTuple_New (n_items + 1);
+    if (py_args != NULL) {
+        Py_INCREF (py_bound_arg);
+        PyTuple_SET_ITEM (py_args, 0, py_bound_arg);
+        for (i = 0; i < n_items; i++) {
+            PyObject *py_arg = PySequence_Fast_GET_ITEM (py_item, i);
+            Py_INCREF (py_arg);
+            PyTuple_SET_ITEM (py_args, i + 1, py_arg);
+        }
+    }
+
+    Py_DECREF (py_item);
+    return py_args;
+}
+
+static gboolean
+_invoke_many_one_by_one (PyGIFunctionCache *function_cache,
+                         PyObject *py_bound_arg,
+                         PyObject *py_seq,
+                         PyObject *py_results)
+{
+    Py_ssize_t i;
+
+    for (i = 0; i < PySequence_Fast_GET_SIZE (py_seq); i++) {
+        PyGIInvokeState state;
+        PyObject *py_args;
+        PyObject *ret;
+
+        py_args = _invoke_many_get_args (py_bound_arg, PySequence_Fast_GET_ITEM (py_seq, i));
+        if (py_args == NULL)
+            return FALSE;
+
+        memset (&state, 0, sizeof (state));
+        ret = function_cache->invoke (function_cache, &state,
+                                      &PyTuple_GET_ITEM (py_args, 0),
+                                      PyTuple_GET_SIZE (py_args),
+                                      NULL);
+        Py_DECREF (py_args);
+        if (ret == NULL)
+            return FALSE;
+
+        PyList_SET_ITEM (py_results, i, ret);
+    }
+
+    return TRUE;
+}
+
+static gboolean
+_invoke_many_batched (PyGIFunctionCache *function_cache,
+                      PyObject *py_bound_arg,
+                      PyObject *py_seq,
+                      PyObject *py_results)
+{
+    PyGICallableCache *cache = (PyGICallableCache *) function_cache;
+    PyGIInvokeState states[PYGI_INVOKE_MANY_BATCH_SIZE];
+    GIFFIReturnValue ffi_return_values[PYGI_INVOKE_MANY_BATCH_SIZE];
+    PyObject *py_args[PYGI_INVOKE_MANY_BATCH_SIZE];
+    Py_ssize_t start, n_items = PySequence_Fast_GET_SIZE (py_seq);
+
+    for (start = 0; start < n_items; start += PYGI_INVOKE_MANY_BATCH_SIZE) {
+        Py_ssize_t i, n = MIN (PYGI_INVOKE_MANY_BATCH_SIZE, n_items - start);
+        PyObject *py_error_type = NULL, *py_error_value = NULL, *py_error_tb = NULL;
+        gboolean failed = FALSE;
+
+        memset (states, 0, n * sizeof (PyGIInvokeState));
+        memset (ffi_return_values, 0, n * sizeof (GIFFIReturnValue));
+
+        for (i = 0; i < n; i++) {
+            PyGIInvokeState *state = &states[i];
+
+            py_args[i] = _invoke_many_get_args (py_bound_arg,
+                                                PySequence_Fast_GET_ITEM (py_seq, start + i));
+            if (py_args[i] == NULL)
+                break;
+
+            if (!_invoke_state_init_from_cache (state, function_cache,
+                                                &PyTuple_GET_ITEM (py_args[i], 0),
+                                                PyTuple_GET_SIZE (py_args[i]),
+                                                NULL) ||
+                    !_invoke_marshal_in_args (state, function_cache)) {
+                _invoke_state_clear (state, function_cache);
+                Py_DECREF (py_args[i]);
+                break;
+            }
+        }
+
+        if (i < n) {
+            /* None of the calls happened, release what was marshaled in
+             * reverse order as the argument state is allocated from a stack.
+             */
+            while (i-- > 0) {
+                pygi_marshal_cleanup_args_from_py_parameter_fail (&states[i], cache,
+                                                                  _pygi_callable_cache_args_len (cache));
+                _invoke_state_clear (&states[i], function_cache);
+                Py_DECREF (py_args[i]);
+            }
+            return FALSE;
+        }
+
+        if (function_cache->release_gil) {
+            Py_BEGIN_ALLOW_THREADS;
+
+                for (i = 0; i < n; i++)
+                    _invoke_ffi_call (function_cache, &states[i], &ffi_return_values[i]);
+
+            Py_END_ALLOW_THREADS;
+        } else {
+            for (i = 0; i < n; i++)
+                _invoke_ffi_call (function_cache, &states[i], &ffi_return_values[i]);
+        }
+
+        /* All calls happened, so all of them need to be finished even if
+         * one fails. The first error is the one raised.
+         */
+        for (i = 0; i < n; i++) {
+            PyObject *ret = _invoke_finish (&states[i], function_cache, &ffi_return_values[i]);
+
+            if (ret == NULL) {
+                if (!failed)
+                    PyErr_Fetch (&py_error_type, &py_error_value, &py_error_tb);
+                else
+                    PyErr_Clear ();
+                failed = TRUE;
+            } else if (failed) {
+                Py_DECREF (ret);
+            } else {
+                PyList_SET_ITEM (py_results, start + i, ret);
+            }
+        }
+
+        for (i = n - 1; i >= 0; i--) {
+            _invoke_state_clear (&states[i], function_cache);
+            Py_DECREF (py_args[i]);
+        }
+
+        if (failed) {
+            PyErr_Restore (py_error_type, py_error_value, py_error_tb);
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+/**
+ * pygi_invoke_c_callable_many:
+ * @function_cache: cache of the callable to invoke
+ * @py_bound_arg: (allow-none): argument passed first in every call
+ * @py_iterable: iterable of argument sequences
+ *
+ * Calls the callable once for each argument sequence. When possible all
+ * arguments of a batch of calls are marshaled first and the C calls are
+ * made with the GIL released only once for the whole batch.
+ *
+ * Returns: new reference to a list of the results or NULL with an
+ *     exception set.
+ */
 PyObject *
-_wrap_g_callable_info_invoke (PyGIBaseInfo *self, PyObject *py_args,
-                              PyObject *kwargs)
+pygi_invoke_c_callable_many (PyGIFunctionCache *function_cache,
+                             PyObject *py_bound_arg,
+                             PyObject *py_iterable)
+{
+    PyObject *py_seq;
+    PyObject *py_results;
+    gboolean success;
+
+    py_seq = PySequence_Fast (py_iterable, "invoke_many() argument must be iterable");
+    if (py_seq == NULL)
+        return NULL;
+
+    py_results = PyList_New (PySequence_Fast_GET_SIZE (py_seq));
+    if (py_results == NULL) {
+        Py_DECREF (py_seq);
+        return NULL;
+    }
+
+    /* The profiler accounts the stages of each call separately */
+    if (!PYGI_PROFILER_IS_ENABLED () && _invoke_many_can_batch (function_cache))
+        success = _invoke_many_batched (function_cache, py_bound_arg, py_seq, py_results);
+    else
+        success = _invoke_many_one_by_one (function_cache, py_bound_arg, py_seq, py_results);
+
+    Py_DECREF (py_seq);
+    if (!success) {
+        Py_DECREF (py_results);
+        return NULL;
+    }
+
+    return py_results;
+}
+
+PyObject *
+pygi_callable_info_invoke (GIBaseInfo *info, PyObject *const *py_args,
+                           Py_ssize_t py_nargs, PyObject *py_kwnames,
+                           PyGICallableCache *cache, gpointer user_data)
+{
+    return pygi_function_cache_invoke ((PyGIFunctionCache *) cache,
+                                       py_args, py_nargs, py_kwnames);
+}
+
+/* _pygi_callable_info_get_function_cache:
+ *
+ * Returns: the function cache of @self, created on first use, or NULL with
+ *     an exception set.
+ */
+PyGIFunctionCache *
+_pygi_callable_info_get_function_cache (PyGIBaseInfo *self)
 {
     if (self->cache == NULL) {
         PyGIFunctionCache *function_cache;
@@ -752,9 +1615,39 @@ _wrap_g_callable_info_invoke (PyGIBaseInfo *self, PyObject *py_args,
         }
 
         self->cache = (PyGICallableCache *)function_cache;
-        if (self->cache == NULL)
-            return NULL;
     }
 
-    return pygi_callable_info_invoke (self->info, py_args, kwargs, self->cache, NULL);
+    return (PyGIFunctionCache *) self->cache;
+}
+
+/* _wrap_g_callable_info_invoke_vector:
+ *
+ * Invokes the callable with an argument vector and a tuple of keyword
+ * names, see pygi_invoke_c_callable. The cache is created on first use.
+ */
+PyObject *
+_wrap_g_callable_info_invoke_vector (PyGIBaseInfo *self, PyObject *const *py_args,
+                                     Py_ssize_t py_nargs, PyObject *py_kwnames)
+{
+    if (_pygi_callable_info_get_function_cache (self) == NULL)
+        return NULL;
+
+    return pygi_callable_info_invoke (self->info, py_args, py_nargs, py_kwnames,
+                                      self->cache, NULL);
+}
+
+PyObject *
+_wrap_g_callable_info_invoke (PyGIBaseInfo *self, PyObject *py_args,
+                              PyObject *kwargs)
+{
+    PyGIInvokeStack stack;
+    PyObject *result;
+
+    if (!pygi_invoke_stack_init (&stack, NULL, py_args, kwargs))
+        return NULL;
+
+    result = _wrap_g_callable_info_invoke_vector (self, stack.args, stack.n_args,
+                                                  stack.kwnames);
+    pygi_invoke_stack_clear (&stack);
+    return result;
 }
@@ -29,19 +29,55 @@
 
 G_BEGIN_DECLS
 
+/* Number of arguments PyGIInvokeStack can hold without allocating. */
+#define PYGI_INVOKE_SMALL_STACK 8
+
+/* Argument vector and keyword names built from a tuple and dict of
+ * arguments, see pygi_invoke_stack_init.
+ */
+typedef struct _PyGIInvokeStack
+{
+    PyObject **args;
+    Py_ssize_t n_args;
+    PyObject *kwnames;
+
+    PyObject **heap;
+    PyObject *small_stack[PYGI_INVOKE_SMALL_STACK];
+} PyGIInvokeStack;
+
+gboolean pygi_invoke_stack_init     (PyGIInvokeStack *stack,
+                                     PyObject *py_bound_arg,
+                                     PyObject *py_args,
+                                     PyObject *py_kwargs);
+void pygi_invoke_stack_clear        (PyGIInvokeStack *stack);
+
 PyObject *pygi_invoke_c_callable    (PyGIFunctionCache *function_cache,
                                      PyGIInvokeState *state,
-                                     PyObject *py_args, PyObject *py_kwargs);
-PyObject *pygi_callable_info_invoke (GIBaseInfo *info, PyObject *py_args,
-                                     PyObject *kwargs, PyGICallableCache *cache,
+                                     PyObject *const *py_args,
+                                     Py_ssize_t py_nargs,
+                                     PyObject *py_kwnames);
+PyObject *pygi_invoke_c_callable_many (PyGIFunctionCache *function_cache,
+                                       PyObject *py_bound_arg,
+                                       PyObject *py_iterable);
+
+PyObject *pygi_callable_info_invoke (GIBaseInfo *info, PyObject *const *py_args,
+                                     Py_ssize_t py_nargs, PyObject *py_kwnames,
+                                     PyGICallableCache *cache,
                                      gpointer user_data);
 PyObject *_wrap_g_callable_info_invoke (PyGIBaseInfo *self, PyObject *py_args,
                                         PyObject *kwargs);
+PyGIFunctionCache *_pygi_callable_info_get_function_cache (PyGIBaseInfo *self);
+PyObject *_wrap_g_callable_info_invoke_vector (PyGIBaseInfo *self,
+                                               PyObject *const *py_args,
+                                               Py_ssize_t py_nargs,
+                                               PyObject *py_kwnames);
 
 gboolean _pygi_invoke_arg_state_init (PyGIInvokeState *state);
 
 void _pygi_invoke_arg_state_free     (PyGIInvokeState *state);
 
+void _pygi_invoke_arg_state_stats    (gsize *hits, gsize *misses);
+
 G_END_DECLS
 
 #endif /* __PYGI_INVOKE_H__ */
@@ -19,6 +19,7 @@
 
 #include "pygi-marshal-cleanup.h"
 #include "pygi-foreign.h"
+#include "pygi-boxed.h"
 #include <glib.h>
 
 static inline void
@@ -34,13 +35,13 @@ _cleanup_caller_allocates (PyGIInvokeState    *state,
     if (g_type_is_a (iface_cache->g_type, G_TYPE_VALUE)) {
         if (was_processed)
             g_value_unset (data);
-        g_slice_free (GValue, data);
+        _pygi_boxed_slice_free (sizeof (GValue), data);
     } else if (g_type_is_a (iface_cache->g_type, G_TYPE_BOXED)) {
         gsize size;
         if (was_processed)
             return; /* will be cleaned up at deallocation */
         size = g_struct_info_get_size (iface_cache->interface_info);
-        g_slice_free1 (size, data);
+        _pygi_boxed_slice_free (size, data);
     } else if (iface_cache->is_foreign) {
         if (was_processed)
             return; /* will be cleaned up at deallocation */
@@ -107,7 +108,7 @@ pygi_marshal_cleanup_args_from_py_marshal_success (PyGIInvokeState   *state,
          */
         if (cleanup_func && cleanup_data != NULL && arg_cache->py_arg_index >= 0 &&
                 arg_cache->direction & PYGI_DIRECTION_FROM_PYTHON) {
-            PyObject *py_arg = PyTuple_GET_ITEM (state->py_in_args, arg_cache->py_arg_index);
+            PyObject *py_arg = state->py_in_args[arg_cache->py_arg_index];
             cleanup_func (state, arg_cache, py_arg, cleanup_data, TRUE);
             state->args[i].arg_cleanup_data = NULL;
         }
@@ -173,7 +174,7 @@ pygi_marshal_cleanup_args_from_py_parameter_fail (PyGIInvokeState   *state,
         if (arg_cache->py_arg_index < 0) {
             continue;
         }
-        py_arg = PyTuple_GET_ITEM (state->py_in_args, arg_cache->py_arg_index);
+        py_arg = state->py_in_args[arg_cache->py_arg_index];
 
         if (cleanup_func && cleanup_data != NULL &&
                 arg_cache->direction == PYGI_DIRECTION_FROM_PYTHON) {
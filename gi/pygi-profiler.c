@@ -0,0 +1,370 @@
+/* -*- Mode: C; c-basic-offset: 4 -*-
+ * vim: tabstop=4 shiftwidth=4 expandtab
+ *
+ *   pygi-profiler.c: per callable invocation statistics
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include <time.h>
+
+#include "pygi-profiler.h"
+#include "pyglib-python-compat.h"
+
+gboolean pygi_profiler_enabled = FALSE;
+gboolean pygi_signal_profiler_enabled = FALSE;
+
+/* Maps the full name of a callable to its PyGIProfileStats. Entries are
+ * never removed, caches keep pointers to their stats and reset only zeroes
+ * them, which also merges the stats of caches of the same callable.
+ */
+static GHashTable *profile_stats = NULL;
+
+/* Set of PyGISignalStats, which are their own keys. Only accessed with the
+ * GIL held.
+ */
+static GHashTable *signal_stats = NULL;
+
+/**
+ * pygi_profiler_now:
+ *
+ * Returns: monotonic time in nanoseconds
+ */
+gint64
+pygi_profiler_now (void)
+{
+#if defined(G_OS_UNIX) && defined(CLOCK_MONOTONIC)
+    struct timespec ts;
+
+    clock_gettime (CLOCK_MONOTONIC, &ts);
+    return (gint64) ts.tv_sec * G_GINT64_CONSTANT (1000000000) + ts.tv_nsec;
+#else
+    return g_get_monotonic_time () * 1000;
+#endif
+}
+
+/**
+ * pygi_profiler_lookup:
+ * @name: full name of the callable
+ *
+ * Returns: the statistics of @name, created on first use.
+ */
+PyGIProfileStats *
+pygi_profiler_lookup (const gchar *name)
+{
+    PyGIProfileStats *stats;
+
+    if (profile_stats == NULL)
+        profile_stats = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                               g_free, g_free);
+
+    stats = g_hash_table_lookup (profile_stats, name);
+    if (stats == NULL) {
+        stats = g_new0 (PyGIProfileStats, 1);
+        g_hash_table_insert (profile_stats, g_strdup (name), stats);
+    }
+
+    return stats;
+}
+
+/**
+ * pygi_profiler_reset:
+ *
+ * Zeroes all collected statistics.
+ */
+void
+pygi_profiler_reset (void)
+{
+    GHashTableIter iter;
+    PyGIProfileStats *stats;
+
+    if (profile_stats == NULL)
+        return;
+
+    g_hash_table_iter_init (&iter, profile_stats);
+    while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &stats))
+        memset (stats, 0, sizeof (PyGIProfileStats));
+}
+
+/**
+ * pygi_profiler_to_py:
+ *
+ * Returns: new reference to a dict mapping callable names to a tuple of
+ *     (calls, closure_calls, in_marshal_time, ffi_call_time,
+ *     out_marshal_time, cleanup_time), times in nanoseconds. Callables
+ *     which were not called since the last reset are left out.
+ */
+PyObject *
+pygi_profiler_to_py (void)
+{
+    GHashTableIter iter;
+    const gchar *name;
+    PyGIProfileStats *stats;
+    PyObject *py_dict;
+
+    py_dict = PyDict_New ();
+    if (py_dict == NULL || profile_stats == NULL)
+        return py_dict;
+
+    g_hash_table_iter_init (&iter, profile_stats);
+    while (g_hash_table_iter_next (&iter, (gpointer *) &name, (gpointer *) &stats)) {
+        PyObject *py_stats;
+
+        if (stats->calls == 0 && stats->closure_calls == 0)
+            continue;
+
+        py_stats = Py_BuildValue ("(KKLLLL)",
+                                  (unsigned PY_LONG_LONG) stats->calls,
+                                  (unsigned PY_LONG_LONG) stats->closure_calls,
+                                  (PY_LONG_LONG) stats->in_marshal_time,
+                                  (PY_LONG_LONG) stats->ffi_call_time,
+                                  (PY_LONG_LONG) stats->out_marshal_time,
+                                  (PY_LONG_LONG) stats->cleanup_time);
+        if (py_stats == NULL || PyDict_SetItemString (py_dict, name, py_stats) < 0) {
+            Py_XDECREF (py_stats);
+            Py_DECREF (py_dict);
+            return NULL;
+        }
+        Py_DECREF (py_stats);
+    }
+
+    return py_dict;
+}
+
+static guint
+_signal_stats_hash (gconstpointer key)
+{
+    const PyGISignalStats *stats = key;
+
+    return (guint) stats->instance_type ^ (stats->signal_id << 16) ^
+        (stats->handler * 31);
+}
+
+static gboolean
+_signal_stats_equal (gconstpointer a, gconstpointer b)
+{
+    const PyGISignalStats *stats_a = a;
+    const PyGISignalStats *stats_b = b;
+
+    return stats_a->instance_type == stats_b->instance_type &&
+        stats_a->signal_id == stats_b->signal_id &&
+        stats_a->handler == stats_b->handler;
+}
+
+/* Returns: the quark of "module.qualname" of @handler or of its type name
+ * if it has no name. Leaves a pending exception, e.g. the one raised by
+ * @handler, untouched. */
+static GQuark
+_signal_handler_quark (PyObject *handler)
+{
+    PyObject *func = handler;
+    PyObject *py_module, *py_name;
+    PyObject *exc_type, *exc_value, *exc_tb;
+    GQuark quark;
+
+    PyErr_Fetch (&exc_type, &exc_value, &exc_tb);
+
+    if (PyMethod_Check (handler))
+        func = PyMethod_GET_FUNCTION (handler);
+
+#if PY_VERSION_HEX >= 0x03030000
+    py_name = PyObject_GetAttrString (func, "__qualname__");
+#else
+    py_name = PyObject_GetAttrString (func, "__name__");
+#endif
+    if (py_name == NULL || !PYGLIB_PyUnicode_Check (py_name)) {
+        PyErr_Clear ();
+        Py_XDECREF (py_name);
+        PyErr_Restore (exc_type, exc_value, exc_tb);
+        return g_quark_from_string (Py_TYPE (handler)->tp_name);
+    }
+
+    py_module = PyObject_GetAttrString (func, "__module__");
+    if (py_module != NULL && PYGLIB_PyUnicode_Check (py_module)) {
+        gchar *name = g_strconcat (PYGLIB_PyUnicode_AsString (py_module), ".",
+                                   PYGLIB_PyUnicode_AsString (py_name), NULL);
+        quark = g_quark_from_string (name);
+        g_free (name);
+    } else {
+        PyErr_Clear ();
+        quark = g_quark_from_string (PYGLIB_PyUnicode_AsString (py_name));
+    }
+
+    Py_XDECREF (py_module);
+    Py_DECREF (py_name);
+    PyErr_Restore (exc_type, exc_value, exc_tb);
+    return quark;
+}
+
+static void
+_signal_profiler_add (GType    instance_type,
+                      guint    signal_id,
+                      GQuark   handler,
+                      gint64   time,
+                      gboolean exception)
+{
+    PyGISignalStats key, *stats;
+
+    if (signal_stats == NULL)
+        signal_stats = g_hash_table_new_full (_signal_stats_hash,
+                                              _signal_stats_equal,
+                                              NULL, g_free);
+
+    key.instance_type = instance_type;
+    key.signal_id = signal_id;
+    key.handler = handler;
+
+    stats = g_hash_table_lookup (signal_stats, &key);
+    if (stats == NULL) {
+        stats = g_new0 (PyGISignalStats, 1);
+        stats->instance_type = key.instance_type;
+        stats->signal_id = key.signal_id;
+        stats->handler = key.handler;
+        g_hash_table_insert (signal_stats, stats, stats);
+    }
+
+    stats->calls++;
+    if (exception)
+        stats->exceptions++;
+    stats->total_time += time;
+    if (time > stats->max_time)
+        stats->max_time = time;
+}
+
+/**
+ * pygi_signal_profiler_record:
+ * @instance_type: type of the emitting instance
+ * @signal_id: the emitted signal
+ * @handler: (allow-none): the called Python handler or %NULL for a whole
+ *     emission from Python
+ * @time: duration of the call in nanoseconds
+ * @exception: whether the call raised an exception
+ *
+ * Adds a call to the statistics. Must be called with the GIL held.
+ */
+void
+pygi_signal_profiler_record (GType     instance_type,
+                             guint     signal_id,
+                             PyObject *handler,
+                             gint64    time,
+                             gboolean  exception)
+{
+    _signal_profiler_add (instance_type, signal_id,
+                          handler != NULL ? _signal_handler_quark (handler) : 0,
+                          time, exception);
+}
+
+/**
+ * pygi_signal_profiler_record_handler:
+ * @invocation_hint: invocation hint passed to the closure marshaller
+ * @param_values: parameters passed to the closure marshaller
+ * @handler: the called Python handler
+ * @handler_name: (allow-none): name of @handler cached by the closure,
+ *     resolved on first use if 0
+ * @start_time: pygi_profiler_now() before calling @handler
+ * @exception: whether the call raised an exception
+ *
+ * Records the call of a signal handler, closures which are not invoked for
+ * a signal emission are ignored.
+ */
+void
+pygi_signal_profiler_record_handler (gpointer      invocation_hint,
+                                     const GValue *param_values,
+                                     PyObject     *handler,
+                                     GQuark       *handler_name,
+                                     gint64        start_time,
+                                     gboolean      exception)
+{
+    GSignalInvocationHint *hint = invocation_hint;
+    gpointer instance;
+    gint64 time = pygi_profiler_now () - start_time;
+    GQuark name;
+
+    if (hint == NULL)
+        return;
+
+    instance = g_value_peek_pointer (&param_values[0]);
+    if (instance == NULL)
+        return;
+
+    if (handler_name != NULL) {
+        if (*handler_name == 0)
+            *handler_name = _signal_handler_quark (handler);
+        name = *handler_name;
+    } else {
+        name = _signal_handler_quark (handler);
+    }
+
+    _signal_profiler_add (G_TYPE_FROM_INSTANCE (instance), hint->signal_id,
+                          name, time, exception);
+}
+
+/**
+ * pygi_signal_profiler_reset:
+ *
+ * Discards all collected signal statistics.
+ */
+void
+pygi_signal_profiler_reset (void)
+{
+    if (signal_stats != NULL)
+        g_hash_table_remove_all (signal_stats);
+}
+
+/**
+ * pygi_signal_profiler_to_py:
+ *
+ * Returns: new reference to a dict mapping tuples of (type name,
+ *     signal name, handler name) to tuples of (calls, exceptions,
+ *     total_time, max_time), times in nanoseconds. The handler name is
+ *     None for the emissions from Python.
+ */
+PyObject *
+pygi_signal_profiler_to_py (void)
+{
+    GHashTableIter iter;
+    PyGISignalStats *stats;
+    PyObject *py_dict;
+
+    py_dict = PyDict_New ();
+    if (py_dict == NULL || signal_stats == NULL)
+        return py_dict;
+
+    g_hash_table_iter_init (&iter, signal_stats);
+    while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &stats)) {
+        PyObject *py_key, *py_stats;
+
+        py_key = Py_BuildValue ("(ssz)",
+                                g_type_name (stats->instance_type),
+                                g_signal_name (stats->signal_id),
+                                g_quark_to_string (stats->handler));
+        py_stats = Py_BuildValue ("(KKLL)",
+                                  (unsigned PY_LONG_LONG) stats->calls,
+                                  (unsigned PY_LONG_LONG) stats->exceptions,
+                                  (PY_LONG_LONG) stats->total_time,
+                                  (PY_LONG_LONG) stats->max_time);
+        if (py_key == NULL || py_stats == NULL ||
+                PyDict_SetItem (py_dict, py_key, py_stats) < 0) {
+            Py_XDECREF (py_key);
+            Py_XDECREF (py_stats);
+            Py_DECREF (py_dict);
+            return NULL;
+        }
+        Py_DECREF (py_key);
+        Py_DECREF (py_stats);
+    }
+
+    return py_dict;
+}
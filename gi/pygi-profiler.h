@@ -0,0 +1,99 @@
+/* -*- Mode: C; c-basic-offset: 4 -*-
+ * vim: tabstop=4 shiftwidth=4 expandtab
+ *
+ *   pygi-profiler.h: per callable invocation statistics
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __PYGI_PROFILER_H__
+#define __PYGI_PROFILER_H__
+
+#include <Python.h>
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+typedef struct _PyGIProfileStats PyGIProfileStats;
+typedef struct _PyGISignalStats PyGISignalStats;
+
+/* All times are in nanoseconds */
+struct _PyGIProfileStats
+{
+    guint64 calls;
+    guint64 closure_calls;
+    gint64 in_marshal_time;
+    gint64 ffi_call_time;
+    gint64 out_marshal_time;
+    gint64 cleanup_time;
+};
+
+/* Statistics of a Python signal handler per instance type and signal, or
+ * of the emissions from Python if handler is 0. Times are in nanoseconds.
+ */
+struct _PyGISignalStats
+{
+    GType instance_type;
+    guint signal_id;
+    GQuark handler;
+
+    guint64 calls;
+    guint64 exceptions;
+    gint64 total_time;
+    gint64 max_time;
+};
+
+/* Checked before doing any profiling work, so the cost of a disabled
+ * profiler is a single branch per call.
+ */
+extern gboolean pygi_profiler_enabled;
+extern gboolean pygi_signal_profiler_enabled;
+
+/* configure --disable-profiler compiles the checks out entirely */
+#ifdef PYGI_DISABLE_PROFILER
+#define PYGI_PROFILER_IS_ENABLED() FALSE
+#define PYGI_SIGNAL_PROFILER_IS_ENABLED() FALSE
+#else
+#define PYGI_PROFILER_IS_ENABLED() G_UNLIKELY (pygi_profiler_enabled)
+#define PYGI_SIGNAL_PROFILER_IS_ENABLED() G_UNLIKELY (pygi_signal_profiler_enabled)
+#endif
+
+gint64             pygi_profiler_now       (void);
+
+PyGIProfileStats * pygi_profiler_lookup    (const gchar *name);
+
+void               pygi_profiler_reset     (void);
+
+PyObject *         pygi_profiler_to_py     (void);
+
+void               pygi_signal_profiler_record         (GType        instance_type,
+                                                        guint        signal_id,
+                                                        PyObject    *handler,
+                                                        gint64       time,
+                                                        gboolean     exception);
+
+void               pygi_signal_profiler_record_handler (gpointer      invocation_hint,
+                                                        const GValue *param_values,
+                                                        PyObject     *handler,
+                                                        GQuark       *handler_name,
+                                                        gint64        start_time,
+                                                        gboolean      exception);
+
+void               pygi_signal_profiler_reset          (void);
+
+PyObject *         pygi_signal_profiler_to_py          (void);
+
+G_END_DECLS
+
+#endif /* __PYGI_PROFILER_H__ */
@@ -24,9 +24,16 @@
 #include "pygi-property.h"
 #include "pygi-value.h"
 #include "pygi-argument.h"
+#include "pygi-object.h"
+#include "pygi-struct-marshal.h"
+#include "pygi-type.h"
 #include "pygparamspec.h"
 #include "pygtype.h"
 
+#include <pyglib-python-compat.h>
+#include <pygenum.h>
+#include <pygflags.h>
+
 #include <girepository.h>
 
 static GIPropertyInfo *
@@ -99,6 +106,150 @@ _pygi_lookup_property_from_g_type (GType g_type, const gchar *attr_name)
     return ret;
 }
 
+/* Introspection data of a property, stored as qdata of its GParamSpec so
+ * only the first get or set of a property looks it up in the repository.
+ */
+typedef struct {
+    GIPropertyInfo *property_info;  /* NULL if the property is not introspected */
+    GITypeInfo *type_info;
+    GITypeTag type_tag;
+    GITransfer transfer;
+
+    /* for GI_TYPE_TAG_INTERFACE */
+    GIBaseInfo *interface_info;
+    GIInfoType interface_type;
+    GType interface_g_type;
+    gboolean is_foreign;
+} PyGIPropertyCache;
+
+static GQuark pygi_property_cache_quark = 0;
+
+static void
+_pygi_property_cache_free (PyGIPropertyCache *cache)
+{
+    if (cache->property_info != NULL)
+        g_base_info_unref (cache->property_info);
+    if (cache->type_info != NULL)
+        g_base_info_unref (cache->type_info);
+    if (cache->interface_info != NULL)
+        g_base_info_unref (cache->interface_info);
+
+    g_slice_free (PyGIPropertyCache, cache);
+}
+
+static PyGIPropertyCache *
+_pygi_property_cache_get (GParamSpec *pspec)
+{
+    PyGIPropertyCache *cache;
+
+    if (G_UNLIKELY (pygi_property_cache_quark == 0))
+        pygi_property_cache_quark = g_quark_from_static_string ("pygi-property-cache");
+
+    cache = g_param_spec_get_qdata (pspec, pygi_property_cache_quark);
+    if (cache != NULL)
+        return cache;
+
+    cache = g_slice_new0 (PyGIPropertyCache);
+
+    /* The owner_type of the pspec gives us the exact type that introduced the
+     * property, even if it is a parent class of the instance in question. */
+    cache->property_info = _pygi_lookup_property_from_g_type (pspec->owner_type,
+                                                              pspec->name);
+    if (cache->property_info != NULL) {
+        cache->type_info = g_property_info_get_type (cache->property_info);
+        cache->type_tag = g_type_info_get_tag (cache->type_info);
+        cache->transfer = g_property_info_get_ownership_transfer (cache->property_info);
+    }
+
+    if (cache->type_tag == GI_TYPE_TAG_INTERFACE) {
+        cache->interface_info = g_type_info_get_interface (cache->type_info);
+        cache->interface_type = g_base_info_get_type (cache->interface_info);
+        cache->interface_g_type = G_TYPE_NONE;
+
+        switch (cache->interface_type) {
+            case GI_INFO_TYPE_STRUCT:
+                cache->is_foreign = g_struct_info_is_foreign ((GIStructInfo *) cache->interface_info);
+                /* fall through */
+            case GI_INFO_TYPE_BOXED:
+            case GI_INFO_TYPE_UNION:
+            case GI_INFO_TYPE_ENUM:
+            case GI_INFO_TYPE_FLAGS:
+            case GI_INFO_TYPE_INTERFACE:
+            case GI_INFO_TYPE_OBJECT:
+                cache->interface_g_type = g_registered_type_info_get_g_type (
+                    (GIRegisteredTypeInfo *) cache->interface_info);
+                break;
+            default:
+                break;
+        }
+    }
+
+    g_param_spec_set_qdata_full (pspec, pygi_property_cache_quark, cache,
+                                 (GDestroyNotify) _pygi_property_cache_free);
+    return cache;
+}
+
+/* Converts the value of an introspected property, calling the
+ * marshaller of the common interface types directly. */
+static PyObject *
+_pygi_property_value_to_py (PyGIPropertyCache *cache, const GValue *value)
+{
+    GIArgument arg;
+    gboolean free_array = FALSE;
+    PyObject *py_value;
+
+    arg = _pygi_argument_from_g_value (value, cache->type_info);
+
+    if (cache->type_tag == GI_TYPE_TAG_INTERFACE &&
+            cache->interface_g_type != G_TYPE_NONE) {
+        switch (cache->interface_type) {
+            case GI_INFO_TYPE_ENUM:
+                return pyg_enum_from_gtype (cache->interface_g_type, arg.v_int);
+            case GI_INFO_TYPE_FLAGS:
+                return pyg_flags_from_gtype (cache->interface_g_type, arg.v_uint);
+            case GI_INFO_TYPE_INTERFACE:
+            case GI_INFO_TYPE_OBJECT:
+                return pygi_arg_gobject_to_py_called_from_c (&arg, GI_TRANSFER_NOTHING);
+            case GI_INFO_TYPE_BOXED:
+            case GI_INFO_TYPE_STRUCT:
+            case GI_INFO_TYPE_UNION:
+            {
+                PyObject *py_type;
+
+                if (cache->interface_g_type == G_TYPE_VARIANT)
+                    break;
+
+                py_type = _pygi_type_get_from_g_type (cache->interface_g_type);
+                py_value = pygi_arg_struct_to_py_marshal (&arg,
+                                                          cache->interface_info,
+                                                          cache->interface_g_type,
+                                                          py_type,
+                                                          GI_TRANSFER_NOTHING,
+                                                          FALSE, /*is_allocated*/
+                                                          cache->is_foreign);
+                Py_XDECREF (py_type);
+                return py_value;
+            }
+            default:
+                break;
+        }
+    }
+
+    /* Arrays are special cased, see note in _pygi_argument_to_array. */
+    if (cache->type_tag == GI_TYPE_TAG_ARRAY) {
+        arg.v_pointer = _pygi_argument_to_array (&arg, NULL, NULL, NULL,
+                                                 cache->type_info, &free_array);
+    }
+
+    py_value = _pygi_argument_to_object (&arg, cache->type_info, GI_TRANSFER_NOTHING);
+
+    if (free_array) {
+        g_array_free (arg.v_pointer, FALSE);
+    }
+
+    return py_value;
+}
+
 PyObject *
 pygi_call_do_get_property (PyObject *instance, GParamSpec *pspec)
 {
@@ -122,7 +273,7 @@ pygi_call_do_get_property (PyObject *instance, GParamSpec *pspec)
 PyObject *
 pygi_get_property_value (PyGObject *instance, GParamSpec *pspec)
 {
-    GIPropertyInfo *property_info = NULL;
+    PyGIPropertyCache *cache;
     GValue value = { 0, };
     PyObject *py_value = NULL;
     GType fundamental;
@@ -152,32 +303,10 @@ pygi_get_property_value (PyGObject *instance, GParamSpec *pspec)
         goto out;
     }
 
-    /* Attempt to marshal through GI.
-     * The owner_type of the pspec gives us the exact type that introduced the
-     * property, even if it is a parent class of the instance in question. */
-    property_info = _pygi_lookup_property_from_g_type (pspec->owner_type, pspec->name);
-    if (property_info) {
-        GITypeInfo *type_info = NULL;
-        gboolean free_array = FALSE;
-        GIArgument arg = { 0, };
-
-        type_info = g_property_info_get_type (property_info);
-        arg = _pygi_argument_from_g_value (&value, type_info);
-
-        /* Arrays are special cased, see note in _pygi_argument_to_array. */
-        if (g_type_info_get_tag (type_info) == GI_TYPE_TAG_ARRAY) {
-            arg.v_pointer = _pygi_argument_to_array (&arg, NULL, NULL, NULL,
-                                                     type_info, &free_array);
-        }
-
-        py_value = _pygi_argument_to_object (&arg, type_info, GI_TRANSFER_NOTHING);
-
-        if (free_array) {
-            g_array_free (arg.v_pointer, FALSE);
-        }
-
-        g_base_info_unref (type_info);
-        g_base_info_unref (property_info);
+    /* Attempt to marshal through GI. */
+    cache = _pygi_property_cache_get (pspec);
+    if (cache->property_info) {
+        py_value = _pygi_property_value_to_py (cache, &value);
     }
 
     /* Fallback to GValue marshalling. */
@@ -212,27 +341,21 @@ pygi_set_property_value (PyGObject *instance,
                          GParamSpec *pspec,
                          PyObject *py_value)
 {
-    GIPropertyInfo *property_info = NULL;
-    GITypeInfo *type_info = NULL;
-    GITypeTag type_tag;
-    GITransfer transfer;
+    PyGIPropertyCache *cache;
+    GITypeInfo *type_info;
     GValue value = { 0, };
     GIArgument arg = { 0, };
     gint ret_value = -1;
 
-    /* The owner_type of the pspec gives us the exact type that introduced the
-     * property, even if it is a parent class of the instance in question. */
-    property_info = _pygi_lookup_property_from_g_type (pspec->owner_type,
-                                                       pspec->name);
-    if (property_info == NULL)
+    cache = _pygi_property_cache_get (pspec);
+    if (cache->property_info == NULL)
         goto out;
 
     if (! (pspec->flags & G_PARAM_WRITABLE))
         goto out;
 
-    type_info = g_property_info_get_type (property_info);
-    transfer = g_property_info_get_ownership_transfer (property_info);
-    arg = _pygi_argument_from_object (py_value, type_info, transfer);
+    type_info = cache->type_info;
+    arg = _pygi_argument_from_object (py_value, type_info, cache->transfer);
 
     if (PyErr_Occurred())
         goto out;
@@ -240,21 +363,12 @@ pygi_set_property_value (PyGObject *instance,
     g_value_init (&value, G_PARAM_SPEC_VALUE_TYPE (pspec));
 
     /* FIXME: Lots of types still unhandled */
-    type_tag = g_type_info_get_tag (type_info);
-    switch (type_tag) {
+    switch (cache->type_tag) {
         case GI_TYPE_TAG_INTERFACE:
         {
-            GIBaseInfo *info;
-            GIInfoType info_type;
-            GType type;
-
-            info = g_type_info_get_interface (type_info);
-            type = g_registered_type_info_get_g_type (info);
-            info_type = g_base_info_get_type (info);
+            GType type = cache->interface_g_type;
 
-            g_base_info_unref (info);
-
-            switch (info_type) {
+            switch (cache->interface_type) {
                 case GI_INFO_TYPE_ENUM:
                     g_value_set_enum (&value, arg.v_int);
                     break;
@@ -375,11 +489,6 @@ pygi_set_property_value (PyGObject *instance,
     ret_value = 0;
 
 out:
-    if (property_info != NULL)
-        g_base_info_unref (property_info);
-    if (type_info != NULL)
-        g_base_info_unref (type_info);
-
     return ret_value;
 }
 
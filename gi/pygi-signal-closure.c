@@ -20,6 +20,10 @@
 #include "pygi-value.h"
 #include "pygi-argument.h"
 #include "pygi-boxed.h"
+#include "pygi-basictype.h"
+#include "pygi-cache.h"
+#include "pygi-profiler.h"
+#include "pygtype.h"
 
 static GISignalInfo *
 _pygi_lookup_signal_from_g_type (GType g_type,
@@ -45,6 +49,104 @@ _pygi_lookup_signal_from_g_type (GType g_type,
     return signal_info;
 }
 
+/* Hack to ensure struct arguments are passed-by-reference allowing
+ * callback implementors to modify the struct values. This is needed
+ * for keeping backwards compatibility and should be removed in future
+ * versions which support signal output arguments as return values.
+ * See: https://bugzilla.gnome.org/show_bug.cgi?id=735486
+ *
+ * Note the logic here must match the logic path taken in _pygi_argument_to_object.
+ */
+static gboolean
+_pygi_signal_arg_pass_struct_by_ref (GITypeInfo *type_info)
+{
+    GIBaseInfo *info;
+    GIInfoType info_type;
+    gboolean pass_struct_by_ref = FALSE;
+
+    info = g_type_info_get_interface (type_info);
+    info_type = g_base_info_get_type (info);
+
+    if (info_type == GI_INFO_TYPE_STRUCT ||
+            info_type == GI_INFO_TYPE_BOXED ||
+            info_type == GI_INFO_TYPE_UNION) {
+
+        GType gtype = g_registered_type_info_get_g_type ((GIRegisteredTypeInfo *) info);
+        gboolean is_foreign = (info_type == GI_INFO_TYPE_STRUCT) &&
+                              (g_struct_info_is_foreign ((GIStructInfo *) info));
+
+        if (!is_foreign && !g_type_is_a (gtype, G_TYPE_VALUE) &&
+                g_type_is_a (gtype, G_TYPE_BOXED)) {
+            pass_struct_by_ref = TRUE;
+        }
+    }
+
+    g_base_info_unref (info);
+    return pass_struct_by_ref;
+}
+
+/* Signal caches shared by all closures of a signal, keyed by the signal
+ * info. Only accessed with the GIL held, the table keeps a reference to
+ * each cache so it survives for later connections.
+ */
+static GHashTable *signal_caches = NULL;
+
+static PyGISignalCache *
+_pygi_signal_cache_ref_for_info (GISignalInfo *signal_info)
+{
+    PyGISignalCache *cache;
+    guint i;
+
+    if (signal_caches == NULL)
+        signal_caches = g_hash_table_new (_pygi_base_info_hash,
+                                          _pygi_base_info_equal);
+
+    cache = g_hash_table_lookup (signal_caches, signal_info);
+    if (cache == NULL) {
+        cache = g_new0 (PyGISignalCache, 1);
+        cache->ref_count = 1;
+        cache->signal_info = g_base_info_ref (signal_info);
+        cache->n_args = g_callable_info_get_n_args (signal_info);
+        cache->args = g_new0 (PyGISignalArgCache, cache->n_args);
+
+        for (i = 0; i < cache->n_args; i++) {
+            PyGISignalArgCache *arg_cache = &cache->args[i];
+            GIArgInfo arg_info;
+
+            g_callable_info_load_arg (signal_info, i, &arg_info);
+            arg_cache->type_info = g_arg_info_get_type (&arg_info);
+            arg_cache->type_tag = g_type_info_get_tag (arg_cache->type_info);
+            arg_cache->is_basic = G_TYPE_TAG_IS_BASIC (arg_cache->type_tag) &&
+                                  arg_cache->type_tag != GI_TYPE_TAG_VOID;
+
+            if (arg_cache->type_tag == GI_TYPE_TAG_INTERFACE)
+                arg_cache->pass_struct_by_ref =
+                    _pygi_signal_arg_pass_struct_by_ref (arg_cache->type_info);
+        }
+
+        g_hash_table_insert (signal_caches, cache->signal_info, cache);
+    }
+
+    g_atomic_int_inc (&cache->ref_count);
+    return cache;
+}
+
+static void
+_pygi_signal_cache_unref (PyGISignalCache *cache)
+{
+    guint i;
+
+    if (!g_atomic_int_dec_and_test (&cache->ref_count))
+        return;
+
+    for (i = 0; i < cache->n_args; i++)
+        g_base_info_unref (cache->args[i].type_info);
+
+    g_free (cache->args);
+    g_base_info_unref (cache->signal_info);
+    g_free (cache);
+}
+
 static void
 pygi_signal_closure_invalidate(gpointer data,
                                GClosure *closure)
@@ -62,8 +164,8 @@ pygi_signal_closure_invalidate(gpointer data,
     pc->extra_args = NULL;
     pc->swap_data = NULL;
 
-    g_base_info_unref (((PyGISignalClosure *) pc)->signal_info);
-    ((PyGISignalClosure *) pc)->signal_info = NULL;
+    _pygi_signal_cache_unref (((PyGISignalClosure *) pc)->signal_cache);
+    ((PyGISignalClosure *) pc)->signal_cache = NULL;
 }
 
 static void
@@ -77,25 +179,34 @@ pygi_signal_closure_marshal(GClosure *closure,
     PyGILState_STATE state;
     PyGClosure *pc = (PyGClosure *)closure;
     PyObject *params, *ret = NULL;
-    guint i;
-    GISignalInfo *signal_info;
-    gint n_sig_info_args;
-    gint sig_info_highest_arg;
+    guint i, n_params;
+    Py_ssize_t n_extra_args;
+    PyGISignalCache *signal_cache;
     GSList *list_item = NULL;
     GSList *pass_by_ref_structs = NULL;
 
     state = PyGILState_Ensure();
 
-    signal_info = ((PyGISignalClosure *)closure)->signal_info;
-    n_sig_info_args = g_callable_info_get_n_args(signal_info);
+    signal_cache = ((PyGISignalClosure *)closure)->signal_cache;
     /* the first argument to a signal callback is instance,
        but instance is not counted in the introspection data */
-    sig_info_highest_arg = n_sig_info_args + 1;
-    g_assert_cmpint(sig_info_highest_arg, ==, n_param_values);
-
-    /* construct Python tuple for the parameter values */
-    params = PyTuple_New(n_param_values);
-    for (i = 0; i < n_param_values; i++) {
+    g_assert_cmpint(signal_cache->n_args + 1, ==, n_param_values);
+
+    /* only convert the parameters the callback accepts */
+    n_params = n_param_values;
+    if (pc->max_params > 0 && (guint) pc->max_params - 1 < n_params)
+        n_params = pc->max_params - 1;
+
+    /* construct Python tuple for the parameter values followed by the
+     * extra arguments */
+    n_extra_args = pc->extra_args ? PyTuple_GET_SIZE(pc->extra_args) : 0;
+    params = PyTuple_New(n_params + n_extra_args);
+    for (i = 0; i < n_extra_args; i++) {
+        PyObject *item = PyTuple_GET_ITEM(pc->extra_args, i);
+        Py_INCREF(item);
+        PyTuple_SET_ITEM(params, n_params + i, item);
+    }
+    for (i = 0; i < n_params; i++) {
         /* swap in a different initial data for connect_object() */
         if (i == 0 && G_CCLOSURE_SWAP_DATA(closure)) {
             g_return_if_fail(pc->swap_data != NULL);
@@ -110,70 +221,38 @@ pygi_signal_closure_marshal(GClosure *closure,
             }
             PyTuple_SetItem(params, i, item);
 
-        } else if (i < sig_info_highest_arg) {
-            GIArgInfo arg_info;
-            GITypeInfo type_info;
-            GITypeTag type_tag;
+        } else {
+            PyGISignalArgCache *arg_cache = &signal_cache->args[i - 1];
             GIArgument arg = { 0, };
             PyObject *item = NULL;
             gboolean free_array = FALSE;
-            gboolean pass_struct_by_ref = FALSE;
-
-            g_callable_info_load_arg(signal_info, i - 1, &arg_info);
-            g_arg_info_load_type(&arg_info, &type_info);
-
-            arg = _pygi_argument_from_g_value(&param_values[i], &type_info);
-
-            type_tag = g_type_info_get_tag (&type_info);
-            if (type_tag == GI_TYPE_TAG_ARRAY) {
-                /* Skip the self argument of param_values */
-                arg.v_pointer = _pygi_argument_to_array (&arg,
-                                                         _pygi_argument_array_length_marshal,
-                                                         (void *)(param_values + 1),
-                                                         signal_info,
-                                                         &type_info,
-                                                         &free_array);
-            }
 
-            /* Hack to ensure struct arguments are passed-by-reference allowing
-             * callback implementors to modify the struct values. This is needed
-             * for keeping backwards compatibility and should be removed in future
-             * versions which support signal output arguments as return values.
-             * See: https://bugzilla.gnome.org/show_bug.cgi?id=735486
-             *
-             * Note the logic here must match the logic path taken in _pygi_argument_to_object.
-             */
-            if (type_tag == GI_TYPE_TAG_INTERFACE) {
-                GIBaseInfo *info = g_type_info_get_interface (&type_info);
-                GIInfoType info_type = g_base_info_get_type (info);
-
-                if (info_type == GI_INFO_TYPE_STRUCT ||
-                        info_type == GI_INFO_TYPE_BOXED ||
-                        info_type == GI_INFO_TYPE_UNION) {
-
-                    GType gtype = g_registered_type_info_get_g_type ((GIRegisteredTypeInfo *) info);
-                    gboolean is_foreign = (info_type == GI_INFO_TYPE_STRUCT) &&
-                                          (g_struct_info_is_foreign ((GIStructInfo *) info));
-
-                    if (!is_foreign && !g_type_is_a (gtype, G_TYPE_VALUE) &&
-                            g_type_is_a (gtype, G_TYPE_BOXED)) {
-                        pass_struct_by_ref = TRUE;
-                    }
-                }
+            arg = _pygi_argument_from_g_value(&param_values[i], arg_cache->type_info);
 
-                g_base_info_unref (info);
-            }
+            if (arg_cache->is_basic) {
+                item = _pygi_marshal_to_py_basic_type (&arg, arg_cache->type_tag,
+                                                       GI_TRANSFER_NOTHING);
 
-            if (pass_struct_by_ref) {
+            } else if (arg_cache->pass_struct_by_ref) {
                 /* transfer everything will ensure the struct is not copied when wrapped. */
-                item = _pygi_argument_to_object (&arg, &type_info, GI_TRANSFER_EVERYTHING);
+                item = _pygi_argument_to_object (&arg, arg_cache->type_info, GI_TRANSFER_EVERYTHING);
                 if (item && PyObject_IsInstance (item, (PyObject *) &PyGIBoxed_Type)) {
                     ((PyGBoxed *)item)->free_on_dealloc = FALSE;
                     pass_by_ref_structs = g_slist_prepend (pass_by_ref_structs, item);
                 }
 
             } else {
-                item = _pygi_argument_to_object (&arg, &type_info, GI_TRANSFER_NOTHING);
+                if (arg_cache->type_tag == GI_TYPE_TAG_ARRAY) {
+                    /* Skip the self argument of param_values */
+                    arg.v_pointer = _pygi_argument_to_array (&arg,
+                                                             _pygi_argument_array_length_marshal,
+                                                             (void *)(param_values + 1),
+                                                             signal_cache->signal_info,
+                                                             arg_cache->type_info,
+                                                             &free_array);
+                }
+
+                item = _pygi_argument_to_object (&arg, arg_cache->type_info, GI_TRANSFER_NOTHING);
             }
 
             if (free_array) {
@@ -186,13 +265,15 @@ pygi_signal_closure_marshal(GClosure *closure,
             PyTuple_SetItem(params, i, item);
         }
     }
-    /* params passed to function may have extra arguments */
-    if (pc->extra_args) {
-        PyObject *tuple = params;
-        params = PySequence_Concat(tuple, pc->extra_args);
-        Py_DECREF(tuple);
+    if (PYGI_SIGNAL_PROFILER_IS_ENABLED ()) {
+        gint64 start_time = pygi_profiler_now ();
+        ret = PyObject_CallObject (pc->callback, params);
+        pygi_signal_profiler_record_handler (invocation_hint, param_values,
+                                             pc->callback, &pc->profiler_name,
+                                             start_time, ret == NULL);
+    } else {
+        ret = PyObject_CallObject (pc->callback, params);
     }
-    ret = PyObject_CallObject(pc->callback, params);
     if (ret == NULL) {
         if (pc->exception_handler)
             pc->exception_handler(return_value, n_param_values, param_values);
@@ -258,7 +339,8 @@ pygi_signal_closure_new (PyGObject *instance,
 
     pygi_closure = (PyGISignalClosure *)closure;
 
-    pygi_closure->signal_info = signal_info;
+    pygi_closure->signal_cache = _pygi_signal_cache_ref_for_info (signal_info);
+    g_base_info_unref (signal_info);
     Py_INCREF(callback);
     pygi_closure->pyg_closure.callback = callback;
 
@@ -271,6 +353,8 @@ pygi_signal_closure_new (PyGObject *instance,
         }
         pygi_closure->pyg_closure.extra_args = extra_args;
     }
+    pygi_closure->pyg_closure.max_params =
+        pyg_closure_get_max_params (callback, pygi_closure->pyg_closure.extra_args);
     if (swap_data) {
         Py_INCREF(swap_data);
         pygi_closure->pyg_closure.swap_data = swap_data;
@@ -30,10 +30,29 @@
 G_BEGIN_DECLS
 
 /* Private */
+
+/* What is needed to convert a signal argument, computed once per signal */
+typedef struct _PyGISignalArgCache
+{
+    GITypeInfo *type_info;
+    GITypeTag type_tag;
+    gboolean is_basic;
+    gboolean pass_struct_by_ref;
+} PyGISignalArgCache;
+
+/* Shared by all closures connected to the same signal */
+typedef struct _PyGISignalCache
+{
+    gint ref_count;
+    GISignalInfo *signal_info;
+    guint n_args;
+    PyGISignalArgCache *args;
+} PyGISignalCache;
+
 typedef struct _PyGISignalClosure
 {
     PyGClosure pyg_closure;
-    GISignalInfo *signal_info;
+    PyGISignalCache *signal_cache;
 } PyGISignalClosure;
 
 GClosure *
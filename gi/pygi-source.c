@@ -34,8 +34,80 @@ typedef struct
 {
     GSource source;
     PyObject *obj;
+
+    /* The prepare, check and dispatch functions of the class of obj, looked
+     * up with the GIL held on the first iteration after attaching the
+     * source. NULL if the class doesn't define them, so the main loop can
+     * skip prepare and check without taking the GIL. Py_None if obj has
+     * the hook in its instance dict, which is then looked up per call. */
+    gint hooks_resolved;
+    PyObject *prepare;
+    PyObject *check;
+    PyObject *dispatch;
 } PyGRealSource;
 
+static PyObject *
+_pyg_source_lookup_hook(PyObject *obj, const char *name)
+{
+    PyObject *hook, **dictptr;
+
+    dictptr = _PyObject_GetDictPtr(obj);
+    if (dictptr != NULL && *dictptr != NULL &&
+	PyDict_GetItemString(*dictptr, name) != NULL) {
+	Py_INCREF(Py_None);
+	return Py_None;
+    }
+
+    hook = PyObject_GetAttrString((PyObject *)Py_TYPE(obj), name);
+    if (hook == NULL)
+	PyErr_Clear();
+
+    return hook;
+}
+
+static void
+_pyg_source_resolve_hooks(PyGRealSource *pysource)
+{
+    pysource->prepare = _pyg_source_lookup_hook(pysource->obj, "prepare");
+    pysource->check = _pyg_source_lookup_hook(pysource->obj, "check");
+    pysource->dispatch = _pyg_source_lookup_hook(pysource->obj, "dispatch");
+    g_atomic_int_set(&pysource->hooks_resolved, TRUE);
+}
+
+/* Returns: %TRUE if the class defines @hook, one of the hook fields of
+ * @pysource. The GIL is taken only to resolve the hooks on first use. */
+static inline gboolean
+_pyg_source_has_hook(PyGRealSource *pysource, PyObject **hook)
+{
+    if (G_UNLIKELY(!g_atomic_int_get(&pysource->hooks_resolved))) {
+	PyGILState_STATE state;
+
+	state = pyglib_gil_state_ensure();
+	if (!pysource->hooks_resolved)
+	    _pyg_source_resolve_hooks(pysource);
+	pyglib_gil_state_release(state);
+    }
+
+    return *hook != NULL;
+}
+
+/* Calls the hook of the class with the source object prepended to @args.
+ * Hooks which are not plain functions, including those set on the
+ * instance, are looked up on the object by @name on every call. */
+static PyObject *
+_pyg_source_call_hook(PyGRealSource *pysource, PyObject *hook,
+		      const char *name, PyObject *arg1, PyObject *arg2)
+{
+    if (hook != NULL &&
+	(PyFunction_Check(hook) ||
+	 (PyMethod_Check(hook) && PyMethod_GET_SELF(hook) == NULL)))
+	return PyObject_CallFunctionObjArgs(hook, pysource->obj, arg1, arg2, NULL);
+
+    if (arg1 != NULL)
+	return PyObject_CallMethod(pysource->obj, (char *)name, "OO", arg1, arg2);
+    return PyObject_CallMethod(pysource->obj, (char *)name, NULL);
+}
+
 static gboolean
 pyg_source_prepare(GSource *source, gint *timeout)
 {
@@ -45,9 +117,14 @@ pyg_source_prepare(GSource *source, gint *timeout)
     gboolean got_err = TRUE;
     PyGILState_STATE state;
 
+    if (!_pyg_source_has_hook(pysource, &pysource->prepare)) {
+	*timeout = -1;
+	return FALSE;
+    }
+
     state = pyglib_gil_state_ensure();
 
-    t = PyObject_CallMethod(pysource->obj, "prepare", NULL);
+    t = _pyg_source_call_hook(pysource, pysource->prepare, "prepare", NULL, NULL);
 
     if (t == NULL) {
 	goto bail;
@@ -94,9 +171,12 @@ pyg_source_check(GSource *source)
     gboolean ret;
     PyGILState_STATE state;
 
+    if (!_pyg_source_has_hook(pysource, &pysource->check))
+	return FALSE;
+
     state = pyglib_gil_state_ensure();
 
-    t = PyObject_CallMethod(pysource->obj, "check", NULL);
+    t = _pyg_source_call_hook(pysource, pysource->check, "check", NULL, NULL);
 
     if (t == NULL) {
 	PyErr_Print();
@@ -119,6 +199,9 @@ pyg_source_dispatch(GSource *source, GSourceFunc callback, gpointer user_data)
     gboolean ret;
     PyGILState_STATE state;
 
+    /* a missing dispatch raises AttributeError below */
+    _pyg_source_has_hook(pysource, &pysource->dispatch);
+
     state = pyglib_gil_state_ensure();
 
     if (callback) {
@@ -131,7 +214,7 @@ pyg_source_dispatch(GSource *source, GSourceFunc callback, gpointer user_data)
 	args = Py_None;
     }
 
-    t = PyObject_CallMethod(pysource->obj, "dispatch", "OO", func, args);
+    t = _pyg_source_call_hook(pysource, pysource->dispatch, "dispatch", func, args);
 
     if (t == NULL) {
 	PyErr_Print();
@@ -155,6 +238,10 @@ pyg_source_finalize(GSource *source)
 
     state = pyglib_gil_state_ensure();
 
+    Py_CLEAR(pysource->prepare);
+    Py_CLEAR(pysource->check);
+    Py_CLEAR(pysource->dispatch);
+
     func = PyObject_GetAttrString(pysource->obj, "finalize");
     if (func) {
 	t = PyObject_CallObject(func, NULL);
@@ -34,6 +34,7 @@
 #include "pygi-type.h"
 #include "pygi-property.h"
 #include "pygi-signal-closure.h"
+#include "pygi-profiler.h"
 
 extern PyObject *PyGIDeprecationWarning;
 
@@ -55,6 +56,8 @@ GQuark pygobject_class_init_key;
 GQuark pygobject_wrapper_key;
 GQuark pygobject_has_updated_constructor_key;
 GQuark pygobject_instance_data_key;
+static GQuark pygobject_props_cache_key;
+static GQuark pygobject_construct_plan_key;
 
 GClosure *
 gclosure_from_pyfunc(PyGObject *object, PyObject *func)
@@ -274,20 +277,65 @@ build_parameter_list(GObjectClass *class)
     return props_list;
 }
 
-static PyObject*
-PyGProps_getattro(PyGProps *self, PyObject *attr)
+/* Per GType cache of the properties looked up through GObject.props,
+ * mapping attribute names to a GParamSpec wrapper, or to None if there is
+ * no such property. All caches are cleared when a type gets properties
+ * installed. Only accessed with the GIL held. */
+typedef struct {
+    guint generation;
+    PyObject *names;
+} PyGPropsCache;
+
+static guint pygobject_props_cache_generation = 0;
+
+/**
+ * pygobject_props_cache_invalidate:
+ *
+ * Clears the property lookup caches, must be called after installing
+ * properties.
+ */
+void
+pygobject_props_cache_invalidate(void)
+{
+    pygobject_props_cache_generation++;
+}
+
+/* Returns: the property @attr of @gtype or %NULL. */
+static GParamSpec *
+pyg_props_lookup(GType gtype, PyObject *attr)
 {
+    PyGPropsCache *cache;
+    PyObject *item;
     char *attr_name, *property_name;
     GObjectClass *class;
     GParamSpec *pspec;
 
+    cache = g_type_get_qdata(gtype, pygobject_props_cache_key);
+    if (cache == NULL) {
+        cache = g_new0(PyGPropsCache, 1);
+        cache->names = PyDict_New();
+        if (cache->names == NULL) {
+            g_free(cache);
+            return NULL;
+        }
+        cache->generation = pygobject_props_cache_generation;
+        g_type_set_qdata(gtype, pygobject_props_cache_key, cache);
+    } else if (cache->generation != pygobject_props_cache_generation) {
+        PyDict_Clear(cache->names);
+        cache->generation = pygobject_props_cache_generation;
+    } else {
+        item = PyDict_GetItem(cache->names, attr);
+        if (item != NULL)
+            return item != Py_None ? pyg_param_spec_get(item) : NULL;
+    }
+
     attr_name = PYGLIB_PyUnicode_AsString(attr);
     if (!attr_name) {
         PyErr_Clear();
-        return PyObject_GenericGetAttr((PyObject *)self, attr);
+        return NULL;
     }
 
-    class = g_type_class_ref(self->gtype);
+    class = g_type_class_ref(gtype);
 
     /* g_object_class_find_property recurses through the class hierarchy,
      * so the resulting pspec tells us the owner_type that owns the property
@@ -298,6 +346,26 @@ PyGProps_getattro(PyGProps *self, PyObject *attr)
     g_free(property_name);
     g_type_class_unref(class);
 
+    if (pspec != NULL) {
+        item = pyg_param_spec_new(pspec);
+    } else {
+        item = Py_None;
+        Py_INCREF(item);
+    }
+    if (item == NULL || PyDict_SetItem(cache->names, attr, item) < 0)
+        PyErr_Clear();
+    Py_XDECREF(item);
+
+    return pspec;
+}
+
+static PyObject*
+PyGProps_getattro(PyGProps *self, PyObject *attr)
+{
+    GParamSpec *pspec;
+
+    pspec = pyg_props_lookup(self->gtype, attr);
+
     if (!pspec) {
 	return PyObject_GenericGetAttr((PyObject *)self, attr);
     }
@@ -353,13 +421,34 @@ set_property_from_pspec(GObject *obj,
 
 PYGLIB_DEFINE_TYPE("gi._gobject.GProps", PyGProps_Type, PyGProps);
 
+static int
+pyg_props_set_value(PyGObject *self, GParamSpec *pspec, PyObject *pvalue)
+{
+    int ret;
+
+    if (!pyg_gtype_is_custom (pspec->owner_type)) {
+        /* This GType is not implemented in Python: see if we can set the
+         * property via gi. */
+        ret = pygi_set_property_value (self, pspec, pvalue);
+        if (ret == 0)
+            return 0;
+        else if (ret == -1 && PyErr_Occurred())
+            return -1;
+    }
+
+    /* This GType is implemented in Python, or we failed to set it via gi:
+     * do a straightforward set. */
+    if (!set_property_from_pspec(self->obj, pspec, pvalue))
+	return -1;
+				  
+    return 0;
+}
+
 static int
 PyGProps_setattro(PyGProps *self, PyObject *attr, PyObject *pvalue)
 {
     GParamSpec *pspec;
-    char *attr_name, *property_name;
     GObject *obj;
-    int ret = -1;
     
     if (pvalue == NULL) {
 	PyErr_SetString(PyExc_TypeError, "properties cannot be "
@@ -367,13 +456,9 @@ PyGProps_setattro(PyGProps *self, PyObject *attr, PyObject *pvalue)
 	return -1;
     }
 
-    attr_name = PYGLIB_PyUnicode_AsString(attr);
-    if (!attr_name) {
-        PyErr_Clear();
-        return PyObject_GenericSetAttr((PyObject *)self, attr, pvalue);
-    }
-
     if (!self->pygobject) {
+        if (!PYGLIB_PyUnicode_Check(attr))
+            return PyObject_GenericSetAttr((PyObject *)self, attr, pvalue);
         PyErr_SetString(PyExc_TypeError,
 			"cannot set GOject properties without an instance");
         return -1;
@@ -381,34 +466,12 @@ PyGProps_setattro(PyGProps *self, PyObject *attr, PyObject *pvalue)
 
     obj = self->pygobject->obj;
 
-    property_name = g_strdup(attr_name);
-    canonicalize_key(property_name);
-
-    /* g_object_class_find_property recurses through the class hierarchy,
-     * so the resulting pspec tells us the owner_type that owns the property
-     * we're dealing with. */
-    pspec = g_object_class_find_property(G_OBJECT_GET_CLASS(obj),
-                                         property_name);
-    g_free(property_name);
+    pspec = pyg_props_lookup(G_OBJECT_TYPE(obj), attr);
     if (!pspec) {
 	return PyObject_GenericSetAttr((PyObject *)self, attr, pvalue);
     }
-    if (!pyg_gtype_is_custom (pspec->owner_type)) {
-        /* This GType is not implemented in Python: see if we can set the
-         * property via gi. */
-        ret = pygi_set_property_value (self->pygobject, pspec, pvalue);
-        if (ret == 0)
-            return 0;
-        else if (ret == -1 && PyErr_Occurred())
-            return -1;
-    }
 
-    /* This GType is implemented in Python, or we failed to set it via gi:
-     * do a straightforward set. */
-    if (!set_property_from_pspec(obj, pspec, pvalue))
-	return -1;
-				  
-    return 0;
+    return pyg_props_set_value(self->pygobject, pspec, pvalue);
 }
 
 static int
@@ -501,6 +564,185 @@ pyg_props_descr_descr_get(PyObject *self, PyObject *obj, PyObject *type)
     return (PyObject *) gprops;
 }
 
+/* -------------- GPropertyDescriptor ----------------- */
+
+/* A data descriptor for a single property, which can be installed on a
+ * wrapper class to access the property as an attribute of its instances
+ * without going through GObject.props. The getter is picked once for the
+ * value type of the property.
+ */
+typedef PyObject *(*PyGPropertyGetFunc) (PyGObject *self, GParamSpec *pspec);
+
+typedef struct {
+    PyObject_HEAD
+    GParamSpec *pspec;
+    PyGPropertyGetFunc get_value;
+} PyGPropertyDescr;
+
+PYGLIB_DEFINE_TYPE("gi._gobject.GPropertyDescriptor", PyGPropertyDescr_Type, PyGPropertyDescr);
+
+/* values which pygi_value_to_py_basic_type() converts */
+static PyObject *
+pyg_property_descr_get_basic(PyGObject *self, GParamSpec *pspec)
+{
+    GValue value = { 0, };
+    PyObject *py_value;
+
+    Py_BEGIN_ALLOW_THREADS;
+    g_value_init(&value, G_PARAM_SPEC_VALUE_TYPE(pspec));
+    g_object_get_property(self->obj, pspec->name, &value);
+    Py_END_ALLOW_THREADS;
+
+    py_value = pygi_value_to_py_basic_type(&value,
+                                           G_TYPE_FUNDAMENTAL(G_VALUE_TYPE(&value)));
+    g_value_unset(&value);
+    return py_value;
+}
+
+static PyObject *
+pyg_property_descr_get_unreadable(PyGObject *self, GParamSpec *pspec)
+{
+    PyErr_Format(PyExc_TypeError, "property %s is not readable", pspec->name);
+    return NULL;
+}
+
+static PyObject *
+pyg_property_descr_new(PyTypeObject *type, PyObject *args, PyObject *kwargs)
+{
+    static char *kwlist[] = { "pspec", NULL };
+    PyObject *py_pspec;
+    PyGPropertyDescr *self;
+    GParamSpec *pspec;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!:GPropertyDescriptor",
+                                     kwlist, &PyGParamSpec_Type, &py_pspec))
+        return NULL;
+
+    pspec = pyg_param_spec_get(py_pspec);
+    if (!g_type_is_a(pspec->owner_type, G_TYPE_OBJECT) &&
+            !G_TYPE_IS_INTERFACE(pspec->owner_type)) {
+        PyErr_Format(PyExc_TypeError, "%s is not a GObject property",
+                     pspec->name);
+        return NULL;
+    }
+    /* Python classes have their own descriptors, which do_get_property()
+     * and do_set_property() look up by name */
+    if (pyg_gtype_is_custom(pspec->owner_type)) {
+        PyErr_Format(PyExc_TypeError, "property %s is implemented in Python",
+                     pspec->name);
+        return NULL;
+    }
+
+    self = (PyGPropertyDescr *)type->tp_alloc(type, 0);
+    if (self == NULL)
+        return NULL;
+
+    self->pspec = g_param_spec_ref(pspec);
+
+    if (!(pspec->flags & G_PARAM_READABLE)) {
+        self->get_value = pyg_property_descr_get_unreadable;
+    } else {
+        switch (G_TYPE_FUNDAMENTAL(G_PARAM_SPEC_VALUE_TYPE(pspec))) {
+            case G_TYPE_CHAR:
+            case G_TYPE_UCHAR:
+            case G_TYPE_BOOLEAN:
+            case G_TYPE_INT:
+            case G_TYPE_UINT:
+            case G_TYPE_LONG:
+            case G_TYPE_ULONG:
+            case G_TYPE_INT64:
+            case G_TYPE_UINT64:
+            case G_TYPE_ENUM:
+            case G_TYPE_FLAGS:
+            case G_TYPE_FLOAT:
+            case G_TYPE_DOUBLE:
+            case G_TYPE_STRING:
+                self->get_value = pyg_property_descr_get_basic;
+                break;
+            default:
+                self->get_value = pygi_get_property_value;
+                break;
+        }
+    }
+
+    return (PyObject *)self;
+}
+
+static void
+pyg_property_descr_dealloc(PyGPropertyDescr *self)
+{
+    g_param_spec_unref(self->pspec);
+    Py_TYPE(self)->tp_free((PyObject *)self);
+}
+
+static PyGObject *
+pyg_property_descr_check_instance(PyGPropertyDescr *self, PyObject *obj)
+{
+    if (!PyObject_TypeCheck(obj, &PyGObject_Type)) {
+        PyErr_SetString(PyExc_TypeError, "cannot use GObject property"
+                        " descriptor on non-GObject instances");
+        return NULL;
+    }
+    if (!G_IS_OBJECT(((PyGObject *)obj)->obj)) {
+        PyErr_Format(PyExc_TypeError,
+                     "object at %p of type %s is not initialized",
+                     obj, Py_TYPE(obj)->tp_name);
+        return NULL;
+    }
+    if (!g_type_is_a(G_OBJECT_TYPE(((PyGObject *)obj)->obj), self->pspec->owner_type)) {
+        PyErr_Format(PyExc_TypeError, "object of type %s does not have "
+                     "property %s", G_OBJECT_TYPE_NAME(((PyGObject *)obj)->obj),
+                     self->pspec->name);
+        return NULL;
+    }
+
+    return (PyGObject *)obj;
+}
+
+static PyObject *
+pyg_property_descr_descr_get(PyGPropertyDescr *self, PyObject *obj, PyObject *type)
+{
+    PyGObject *pygobject;
+
+    /* like Class.props.name */
+    if (obj == NULL || obj == Py_None)
+        return pyg_param_spec_new(self->pspec);
+
+    pygobject = pyg_property_descr_check_instance(self, obj);
+    if (pygobject == NULL)
+        return NULL;
+
+    return self->get_value(pygobject, self->pspec);
+}
+
+static int
+pyg_property_descr_descr_set(PyGPropertyDescr *self, PyObject *obj, PyObject *pvalue)
+{
+    PyGObject *pygobject;
+
+    if (pvalue == NULL) {
+        PyErr_SetString(PyExc_TypeError, "properties cannot be deleted");
+        return -1;
+    }
+
+    pygobject = pyg_property_descr_check_instance(self, obj);
+    if (pygobject == NULL)
+        return -1;
+
+    return pyg_props_set_value(pygobject, self->pspec, pvalue);
+}
+
+static PyObject *
+pyg_property_descr_get_pspec(PyGPropertyDescr *self, void *closure)
+{
+    return pyg_param_spec_new(self->pspec);
+}
+
+static PyGetSetDef pyg_property_descr_getsets[] = {
+    { "pspec", (getter)pyg_property_descr_get_pspec, (setter)0 },
+    { NULL, 0, 0 }
+};
+
 /**
  * pygobject_register_class:
  * @dict: the module dictionary.  A reference to the type will be stored here.
@@ -1206,6 +1448,113 @@ pygobject_free(PyObject *op)
     PyObject_GC_Del(op);
 }
 
+/* Construct property plan: per type, a dict mapping keyword argument names
+ * to a PyGConstructProp capsule, so constructing objects with keyword
+ * arguments doesn't look up each property by name. Only accessed with the
+ * GIL held. */
+typedef int (*PyGConstructPropFromPy)(GValue *value, PyObject *py_obj,
+                                      const GParamSpec *pspec);
+
+typedef struct {
+    GParamSpec *pspec;
+    PyGConstructPropFromPy from_py;
+} PyGConstructProp;
+
+#define PYG_CONSTRUCT_PROP_CAPSULE "gi._gobject.ConstructProp"
+
+/* Parameter buffer reused between constructions, owned by whoever called
+ * pygobject_prepare_construct_properties() until it is handed back through
+ * pygobject_free_construct_properties(). */
+static GParameter *construct_params_buffer = NULL;
+static guint construct_params_buffer_size = 0;
+
+static int
+pyg_construct_prop_from_py_value(GValue *value, PyObject *py_obj,
+                                 const GParamSpec *pspec)
+{
+    return pyg_value_from_pyobject(value, py_obj);
+}
+
+static void
+pyg_construct_prop_destroy(PyObject *capsule)
+{
+    PyGConstructProp *prop;
+
+    prop = PyCapsule_GetPointer(capsule, PYG_CONSTRUCT_PROP_CAPSULE);
+    g_param_spec_unref(prop->pspec);
+    g_slice_free(PyGConstructProp, prop);
+}
+
+/* Returns: the construct property for keyword @key of @class, or %NULL
+ * with an exception set. */
+static PyGConstructProp *
+pyg_construct_prop_lookup(GObjectClass *class, PyObject *key)
+{
+    GType gtype = G_OBJECT_CLASS_TYPE(class);
+    PyObject *plan, *item;
+    PyGConstructProp *prop;
+    GParamSpec *pspec;
+    const gchar *key_str;
+
+    plan = g_type_get_qdata(gtype, pygobject_construct_plan_key);
+    if (plan == NULL) {
+        plan = PyDict_New();
+        if (plan == NULL)
+            return NULL;
+        g_type_set_qdata(gtype, pygobject_construct_plan_key, plan);
+    } else {
+        item = PyDict_GetItem(plan, key);
+        if (item != NULL)
+            return PyCapsule_GetPointer(item, PYG_CONSTRUCT_PROP_CAPSULE);
+    }
+
+    key_str = PYGLIB_PyUnicode_AsString(key);
+    if (key_str == NULL)
+        return NULL;
+
+    pspec = g_object_class_find_property(class, key_str);
+    if (!pspec) {
+        PyErr_Format(PyExc_TypeError,
+                     "gobject `%s' doesn't support property `%s'",
+                     G_OBJECT_CLASS_NAME(class), key_str);
+        return NULL;
+    }
+
+    prop = g_slice_new(PyGConstructProp);
+    prop->pspec = g_param_spec_ref(pspec);
+    if (G_IS_PARAM_SPEC_UNICHAR(pspec) || G_IS_PARAM_SPEC_VALUE_ARRAY(pspec))
+        prop->from_py = pyg_param_gvalue_from_pyobject;
+    else
+        prop->from_py = pyg_construct_prop_from_py_value;
+
+    item = PyCapsule_New(prop, PYG_CONSTRUCT_PROP_CAPSULE,
+                         pyg_construct_prop_destroy);
+    if (item == NULL) {
+        g_param_spec_unref(prop->pspec);
+        g_slice_free(PyGConstructProp, prop);
+        return NULL;
+    }
+    /* Failing to cache the entry only costs a lookup next time. */
+    if (PyDict_SetItem(plan, key, item) < 0)
+        PyErr_Clear();
+    Py_DECREF(item);
+
+    return prop;
+}
+
+/**
+ * pygobject_prepare_construct_properties:
+ * @class: the class of the object to construct
+ * @kwargs: (allow-none): keyword arguments mapping property names to values
+ * @n_params: (out): number of parameters
+ * @params: (out): parameters for g_object_newv()
+ *
+ * Converts @kwargs to construct parameters. The parameter names are owned
+ * by the property specs of @class and must not be freed; release the
+ * parameters with pygobject_free_construct_properties(), also on failure.
+ *
+ * Returns: %TRUE on success, %FALSE with an exception set otherwise.
+ */
 gboolean
 pygobject_prepare_construct_properties(GObjectClass *class, PyObject *kwargs,
                                        guint *n_params, GParameter **params)
@@ -1214,45 +1563,84 @@ pygobject_prepare_construct_properties(GObjectClass *class, PyObject *kwargs,
     *params = NULL;
 
     if (kwargs) {
-        Py_ssize_t pos = 0;
+        Py_ssize_t pos = 0, size;
         PyObject *key;
         PyObject *value;
 
-        *params = g_new0(GParameter, PyDict_Size(kwargs));
+        size = PyDict_Size(kwargs);
+        if (size == 0)
+            return TRUE;
+
+        if (construct_params_buffer != NULL && construct_params_buffer_size >= size) {
+            *params = construct_params_buffer;
+            construct_params_buffer = NULL;
+        } else {
+            *params = g_new0(GParameter, size);
+        }
+
         while (PyDict_Next(kwargs, &pos, &key, &value)) {
-            GParamSpec *pspec;
+            PyGConstructProp *prop;
             GParameter *param = &(*params)[*n_params];
-            const gchar *key_str = PYGLIB_PyUnicode_AsString(key);
 
-            pspec = g_object_class_find_property(class, key_str);
-            if (!pspec) {
-                PyErr_Format(PyExc_TypeError,
-                             "gobject `%s' doesn't support property `%s'",
-                             G_OBJECT_CLASS_NAME(class), key_str);
+            prop = pyg_construct_prop_lookup(class, key);
+            if (prop == NULL)
                 return FALSE;
-            }
-            g_value_init(&param->value, G_PARAM_SPEC_VALUE_TYPE(pspec));
-            if (pyg_param_gvalue_from_pyobject(&param->value, value, pspec) < 0) {
+
+            g_value_init(&param->value, G_PARAM_SPEC_VALUE_TYPE(prop->pspec));
+            if (prop->from_py(&param->value, value, prop->pspec) < 0) {
+                g_value_unset(&param->value);
                 PyErr_Format(PyExc_TypeError,
                              "could not convert value for property `%s' from %s to %s",
-                             key_str, Py_TYPE(value)->tp_name,
-                             g_type_name(G_PARAM_SPEC_VALUE_TYPE(pspec)));
+                             PYGLIB_PyUnicode_AsString(key), Py_TYPE(value)->tp_name,
+                             g_type_name(G_PARAM_SPEC_VALUE_TYPE(prop->pspec)));
                 return FALSE;
             }
-            param->name = g_strdup(key_str);
+            param->name = prop->pspec->name;
             ++(*n_params);
         }
     }
     return TRUE;
 }
 
+/**
+ * pygobject_free_construct_properties:
+ * @n_params: number of parameters
+ * @params: parameters from pygobject_prepare_construct_properties()
+ *
+ * Releases parameters returned by pygobject_prepare_construct_properties().
+ */
+void
+pygobject_free_construct_properties(guint n_params, GParameter *params)
+{
+    guint i;
+
+    if (params == NULL)
+        return;
+
+    for (i = 0; i < n_params; i++)
+        g_value_unset(&params[i].value);
+
+    /* Keep the largest buffer around for the next construction,
+     * g_value_unset() leaves the values zeroed. */
+    if (construct_params_buffer == NULL) {
+        construct_params_buffer = params;
+        construct_params_buffer_size = n_params;
+    } else if (construct_params_buffer_size < n_params) {
+        g_free(construct_params_buffer);
+        construct_params_buffer = params;
+        construct_params_buffer_size = n_params;
+    } else {
+        g_free(params);
+    }
+}
+
 /* ---------------- PyGObject methods ----------------- */
 
 static int
 pygobject_init(PyGObject *self, PyObject *args, PyObject *kwargs)
 {
     GType object_type;
-    guint n_params = 0, i;
+    guint n_params = 0;
     GParameter *params = NULL;
     GObjectClass *class;
 
@@ -1294,11 +1682,7 @@ pygobject_init(PyGObject *self, PyObject *args, PyObject *kwargs)
 	PyErr_SetString(PyExc_RuntimeError, "could not create object");
 
  cleanup:
-    for (i = 0; i < n_params; i++) {
-	g_free((gchar *) params[i].name);
-	g_value_unset(&params[i].value);
-    }
-    g_free(params);
+    pygobject_free_construct_properties(n_params, params);
     g_type_class_unref(class);
     
     return (self->obj) ? 0 : -1;
@@ -1611,7 +1995,7 @@ pygobject_bind_property(PyGObject *self, PyObject *args)
 }
 
 static PyObject *
-connect_helper(PyGObject *self, gchar *name, PyObject *callback, PyObject *extra_args, PyObject *object, gboolean after)
+connect_helper(PyGObject *self, gchar *name, PyObject *callback, PyObject *extra_args, PyObject *object, gboolean after, gboolean coalesce)
 {
     guint sigid;
     GQuark detail = 0;
@@ -1638,6 +2022,18 @@ connect_helper(PyGObject *self, gchar *name, PyObject *callback, PyObject *extra
         }
     }
 
+    if (coalesce) {
+        if (sigid != g_signal_lookup ("notify", G_TYPE_OBJECT)) {
+            PyErr_Format (PyExc_TypeError,
+                          "coalesce is only supported for notify signals, not %s",
+                          name);
+            return NULL;
+        }
+
+        closure = pyg_coalesced_notify_closure_new (callback, extra_args);
+        goto connect;
+    }
+
     g_signal_query (sigid, &query_info);
     if (!pyg_gtype_is_custom (query_info.itype)) {
         /* The signal is implemented by a non-Python class, probably
@@ -1653,16 +2049,44 @@ connect_helper(PyGObject *self, gchar *name, PyObject *callback, PyObject *extra
         closure = pyg_closure_new (callback, extra_args, object);
     }
 
+connect:
     pygobject_watch_closure((PyObject *)self, closure);
     handlerid = g_signal_connect_closure_by_id(self->obj, sigid, detail,
 					       closure, after);
     return PyLong_FromUnsignedLong(handlerid);
 }
 
+/* Parses the keyword arguments of connect() and connect_after() */
+static gboolean
+connect_parse_kwargs(PyObject *kwargs, gboolean *coalesce)
+{
+    PyObject *py_coalesce;
+    int ret;
+
+    *coalesce = FALSE;
+    if (kwargs == NULL || PyDict_Size(kwargs) == 0)
+        return TRUE;
+
+    py_coalesce = PyDict_GetItemString(kwargs, "coalesce");
+    if (py_coalesce == NULL || PyDict_Size(kwargs) > 1) {
+        PyErr_SetString(PyExc_TypeError,
+                        "'coalesce' is the only supported keyword argument");
+        return FALSE;
+    }
+
+    ret = PyObject_IsTrue(py_coalesce);
+    if (ret < 0)
+        return FALSE;
+
+    *coalesce = ret;
+    return TRUE;
+}
+
 static PyObject *
-pygobject_connect(PyGObject *self, PyObject *args)
+pygobject_connect(PyGObject *self, PyObject *args, PyObject *kwargs)
 {
     PyObject *first, *callback, *extra_args, *ret;
+    gboolean coalesce;
     gchar *name;
     guint len;
 
@@ -1684,20 +2108,24 @@ pygobject_connect(PyGObject *self, PyObject *args)
     }
     
     CHECK_GOBJECT(self);
+
+    if (!connect_parse_kwargs(kwargs, &coalesce))
+	return NULL;
     
     extra_args = PySequence_GetSlice(args, 2, len);
     if (extra_args == NULL)
 	return NULL;
 
-    ret = connect_helper(self, name, callback, extra_args, NULL, FALSE);
+    ret = connect_helper(self, name, callback, extra_args, NULL, FALSE, coalesce);
     Py_DECREF(extra_args);
     return ret;
 }
 
 static PyObject *
-pygobject_connect_after(PyGObject *self, PyObject *args)
+pygobject_connect_after(PyGObject *self, PyObject *args, PyObject *kwargs)
 {
     PyObject *first, *callback, *extra_args, *ret;
+    gboolean coalesce;
     gchar *name;
     Py_ssize_t len;
 
@@ -1720,12 +2148,15 @@ pygobject_connect_after(PyGObject *self, PyObject *args)
     }
     
     CHECK_GOBJECT(self);
+
+    if (!connect_parse_kwargs(kwargs, &coalesce))
+	return NULL;
     
     extra_args = PySequence_GetSlice(args, 2, len);
     if (extra_args == NULL)
 	return NULL;
 
-    ret = connect_helper(self, name, callback, extra_args, NULL, TRUE);
+    ret = connect_helper(self, name, callback, extra_args, NULL, TRUE, coalesce);
     Py_DECREF(extra_args);
     return ret;
 }
@@ -1761,7 +2192,7 @@ pygobject_connect_object(PyGObject *self, PyObject *args)
     if (extra_args == NULL)
 	return NULL;
 
-    ret = connect_helper(self, name, callback, extra_args, object, FALSE);
+    ret = connect_helper(self, name, callback, extra_args, object, FALSE, FALSE);
     Py_DECREF(extra_args);
     return ret;
 }
@@ -1797,7 +2228,7 @@ pygobject_connect_object_after(PyGObject *self, PyObject *args)
     if (extra_args == NULL)
 	return NULL;
 
-    ret = connect_helper(self, name, callback, extra_args, object, TRUE);
+    ret = connect_helper(self, name, callback, extra_args, object, TRUE, FALSE);
     Py_DECREF(extra_args);
     return ret;
 }
@@ -1812,6 +2243,10 @@ pygobject_emit(PyGObject *self, PyObject *args)
     gchar *name;
     GSignalQuery query;
     GValue *params, ret = { 0, };
+    PyGSignalEmission emission = { NULL, };
+    PyObject *py_params_stack[8];
+    gboolean is_custom;
+    gint64 start_time = 0;
     
     len = PyTuple_Size(args);
     if (len < 1) {
@@ -1851,6 +2286,18 @@ pygobject_emit(PyGObject *self, PyObject *args)
     g_value_init(&params[0], G_OBJECT_TYPE(self->obj));
     g_value_set_object(&params[0], G_OBJECT(self->obj));
 
+    /* Handlers of signals defined in Python get the arguments passed here
+     * where converting the GValues back would give the same objects. */
+    is_custom = pyg_gtype_is_custom(query.itype);
+    if (is_custom) {
+	if (query.n_params + 1 <= G_N_ELEMENTS(py_params_stack))
+	    emission.py_params = py_params_stack;
+	else
+	    emission.py_params = g_new(PyObject *, query.n_params + 1);
+	emission.params = params;
+	emission.py_params[0] = (PyObject *)self;
+    }
+
     for (i = 0; i < query.n_params; i++)
 	g_value_init(&params[i + 1],
 		     query.param_types[i] & ~G_SIGNAL_TYPE_STATIC_SCOPE);
@@ -1869,14 +2316,36 @@ pygobject_emit(PyGObject *self, PyObject *args)
 		g_value_unset(&params[j]);
 
 	    g_free(params);
+	    if (emission.py_params != py_params_stack)
+		g_free(emission.py_params);
 	    return NULL;
 	}
+
+	if (is_custom) {
+	    emission.py_params[i + 1] =
+		pyg_signal_emission_param_reusable(&params[i + 1], item) ? item : NULL;
+	}
     }    
 
     if (query.return_type != G_TYPE_NONE)
 	g_value_init(&ret, query.return_type & ~G_SIGNAL_TYPE_STATIC_SCOPE);
     
-    g_signal_emitv(params, signal_id, detail, &ret);
+    if (PYGI_SIGNAL_PROFILER_IS_ENABLED())
+	start_time = pygi_profiler_now();
+
+    if (is_custom) {
+	pyg_signal_emission_push(&emission);
+	g_signal_emitv(params, signal_id, detail, &ret);
+	pyg_signal_emission_pop(&emission);
+	if (emission.py_params != py_params_stack)
+	    g_free(emission.py_params);
+    } else {
+	g_signal_emitv(params, signal_id, detail, &ret);
+    }
+
+    if (G_UNLIKELY(start_time != 0))
+	pygi_signal_profiler_record(G_OBJECT_TYPE(self->obj), signal_id, NULL,
+				    pygi_profiler_now() - start_time, FALSE);
 
     for (i = 0; i < query.n_params + 1; i++)
 	g_value_unset(&params[i]);
@@ -2121,8 +2590,8 @@ static PyMethodDef pygobject_methods[] = {
     { "set_property", (PyCFunction)pygobject_set_property, METH_VARARGS },
     { "set_properties", (PyCFunction)pygobject_set_properties, METH_VARARGS|METH_KEYWORDS },
     { "bind_property", (PyCFunction)pygobject_bind_property, METH_VARARGS|METH_KEYWORDS },
-    { "connect", (PyCFunction)pygobject_connect, METH_VARARGS },
-    { "connect_after", (PyCFunction)pygobject_connect_after, METH_VARARGS },
+    { "connect", (PyCFunction)pygobject_connect, METH_VARARGS|METH_KEYWORDS },
+    { "connect_after", (PyCFunction)pygobject_connect_after, METH_VARARGS|METH_KEYWORDS },
     { "connect_object", (PyCFunction)pygobject_connect_object, METH_VARARGS },
     { "connect_object_after", (PyCFunction)pygobject_connect_object_after, METH_VARARGS },
     { "disconnect_by_func", (PyCFunction)pygobject_disconnect_by_func, METH_VARARGS },
@@ -2355,6 +2824,8 @@ pygobject_object_register_types(PyObject *d)
     pygobject_has_updated_constructor_key =
         g_quark_from_static_string("PyGObject::has-updated-constructor");
     pygobject_instance_data_key = g_quark_from_static_string("PyGObject::instance-data");
+    pygobject_props_cache_key = g_quark_from_static_string("PyGObject::props-cache");
+    pygobject_construct_plan_key = g_quark_from_static_string("PyGObject::construct-plan");
 
     /* GObject */
     if (!PY_TYPE_OBJECT)
@@ -2408,6 +2879,17 @@ pygobject_object_register_types(PyObject *d)
                         o=PYGLIB_PyUnicode_FromString("gi._gobject._gobject"));
     Py_DECREF(o);
 
+    /* GPropertyDescriptor */
+    PyGPropertyDescr_Type.tp_new = pyg_property_descr_new;
+    PyGPropertyDescr_Type.tp_dealloc = (destructor)pyg_property_descr_dealloc;
+    PyGPropertyDescr_Type.tp_flags = Py_TPFLAGS_DEFAULT;
+    PyGPropertyDescr_Type.tp_doc = "Descriptor accessing a GObject property "
+	"as an attribute of the instances.";
+    PyGPropertyDescr_Type.tp_descr_get = (descrgetfunc)pyg_property_descr_descr_get;
+    PyGPropertyDescr_Type.tp_descr_set = (descrsetfunc)pyg_property_descr_descr_set;
+    PyGPropertyDescr_Type.tp_getset = pyg_property_descr_getsets;
+    PYGLIB_REGISTER_TYPE(d, PyGPropertyDescr_Type, "GPropertyDescriptor");
+
     /* GPropsIter */
     PyGPropsIter_Type.tp_dealloc = (destructor)pyg_props_iter_dealloc;
     PyGPropsIter_Type.tp_flags = Py_TPFLAGS_DEFAULT;
@@ -37,6 +37,8 @@ gboolean      pygobject_prepare_construct_properties  (GObjectClass *class,
                                                        PyObject *kwargs,
                                                        guint *n_params,
                                                        GParameter **params);
+void          pygobject_free_construct_properties     (guint n_params,
+                                                       GParameter *params);
 void          pygobject_register_class   (PyObject *dict,
                                           const gchar *type_name,
                                           GType gtype, PyTypeObject *type,
@@ -45,6 +47,7 @@ void          pygobject_register_wrapper (PyObject *self);
 PyObject *    pygobject_new              (GObject *obj);
 PyObject *    pygobject_new_full         (GObject *obj, gboolean steal, gpointer g_class);
 void          pygobject_sink             (GObject *obj);
+void          pygobject_props_cache_invalidate (void);
 PyTypeObject *pygobject_lookup_class     (GType gtype);
 void          pygobject_watch_closure    (PyObject *self, GClosure *closure);
 void          pygobject_object_register_types(PyObject *d);
@@ -20,6 +20,8 @@ struct _PyGClosure {
     PyObject *extra_args; /* tuple of extra args to pass to callback */
     PyObject *swap_data; /* other object for gtk_signal_connect__object */
     PyClosureExceptionHandler exception_handler;
+    gint max_params; /* signal params passed to callback plus one, 0 for all */
+    GQuark profiler_name; /* callback name for the signal profiler, 0 until resolved */
 };
 
 typedef enum {
@@ -22,7 +22,10 @@
 #  include <config.h>
 #endif
 
+#include <string.h>
+
 #include <pyglib.h>
+#include <code.h>
 
 #include "pygobject-object.h"
 #include "pygboxed.h"
@@ -35,6 +38,7 @@
 
 #include "pygi-type.h"
 #include "pygi-value.h"
+#include "pygi-profiler.h"
 
 /* -------------- __gtype__ objects ---------------------------- */
 
@@ -662,6 +666,158 @@ pyg_register_gtype_custom(GType gtype,
     g_type_set_qdata(gtype, pyg_type_marshal_key, tm);
 }
 
+/* -------------- PyGSignalEmission ----------------- */
+/* Signals defined in Python and emitted from Python still go through
+ * g_signal_emitv() so handler order, blocking, details and accumulators
+ * work as usual, but the Python handlers get the objects passed to emit()
+ * instead of converting the GValues back, when that would give the same
+ * object anyway.
+ *
+ * Emissions in progress are linked in a list which is only accessed with
+ * the GIL held. Handlers find their emission by the parameter array, which
+ * g_signal_emitv() passes on to the closures unchanged.
+ */
+static PyGSignalEmission *signal_emissions = NULL;
+
+/* Returns: %TRUE if the exact int @obj equals the integer held by @value,
+ * i.e. storing it in @value didn't truncate it. */
+static gboolean
+pyg_signal_emission_int_matches(const GValue *value, PyObject *obj)
+{
+    PY_LONG_LONG v;
+
+#if PY_VERSION_HEX < 0x03000000
+    v = PyInt_AS_LONG(obj);
+#else
+    {
+        int overflow;
+
+        v = PyLong_AsLongLongAndOverflow(obj, &overflow);
+        if (overflow != 0)
+            return FALSE;
+    }
+#endif
+
+    switch (G_TYPE_FUNDAMENTAL(G_VALUE_TYPE(value))) {
+    case G_TYPE_INT:
+        return v == g_value_get_int(value);
+    case G_TYPE_UINT:
+        return v >= 0 && (guint64)v == g_value_get_uint(value);
+    case G_TYPE_LONG:
+        return v == g_value_get_long(value);
+    case G_TYPE_ULONG:
+        return v >= 0 && (guint64)v == g_value_get_ulong(value);
+    case G_TYPE_INT64:
+        return v == g_value_get_int64(value);
+    case G_TYPE_UINT64:
+        return v >= 0 && (guint64)v == g_value_get_uint64(value);
+    default:
+        return FALSE;
+    }
+}
+
+/**
+ * pyg_signal_emission_param_reusable:
+ * @value: the signal parameter
+ * @obj: the object converted to @value
+ *
+ * Returns: %TRUE if converting @value back gives an object equal to
+ *     @obj and of the same type.
+ */
+gboolean
+pyg_signal_emission_param_reusable(const GValue *value, PyObject *obj)
+{
+    GType type = G_VALUE_TYPE(value);
+
+    if (type == PY_TYPE_OBJECT)
+        return TRUE;
+
+    switch (G_TYPE_FUNDAMENTAL(type)) {
+    case G_TYPE_OBJECT:
+        return obj == Py_None || PyObject_TypeCheck(obj, &PyGObject_Type);
+    case G_TYPE_BOOLEAN:
+        return PyBool_Check(obj);
+    case G_TYPE_INT:
+    case G_TYPE_UINT:
+    case G_TYPE_LONG:
+    case G_TYPE_ULONG:
+    case G_TYPE_INT64:
+    case G_TYPE_UINT64:
+        /* values out of range get truncated or wrapped in the GValue */
+        return Py_TYPE(obj) == &PYGLIB_PyLong_Type &&
+            pyg_signal_emission_int_matches(value, obj);
+    case G_TYPE_DOUBLE:
+        return PyFloat_CheckExact(obj);
+    case G_TYPE_STRING:
+    {
+        gchar *str;
+        Py_ssize_t size;
+
+        if (obj == Py_None)
+            return TRUE;
+        if (Py_TYPE(obj) != &PYGLIB_PyUnicode_Type ||
+                PYGLIB_PyUnicode_AsStringAndSize(obj, &str, &size) < 0) {
+            PyErr_Clear();
+            return FALSE;
+        }
+        /* the GValue is cut at embedded nul characters */
+        return strlen(str) == (size_t)size;
+    }
+    default:
+        return FALSE;
+    }
+}
+
+void
+pyg_signal_emission_push(PyGSignalEmission *emission)
+{
+    emission->next = signal_emissions;
+    signal_emissions = emission;
+}
+
+void
+pyg_signal_emission_pop(PyGSignalEmission *emission)
+{
+    PyGSignalEmission **link;
+
+    /* usually the first one, unless other threads emitted meanwhile */
+    for (link = &signal_emissions; *link != NULL; link = &(*link)->next) {
+        if (*link == emission) {
+            *link = emission->next;
+            break;
+        }
+    }
+}
+
+static inline PyGSignalEmission *
+pyg_signal_emission_find(const GValue *param_values)
+{
+    PyGSignalEmission *emission;
+
+    for (emission = signal_emissions; emission != NULL; emission = emission->next) {
+        if (emission->params == param_values)
+            return emission;
+    }
+
+    return NULL;
+}
+
+/* Returns: new reference to parameter @i of the emission or the converted
+ * GValue. */
+static inline PyObject *
+pyg_signal_emission_get_param(PyGSignalEmission *emission,
+                              const GValue *param_values,
+                              guint i,
+                              gboolean copy_boxed)
+{
+    if (emission != NULL && emission->py_params[i] != NULL) {
+        Py_INCREF(emission->py_params[i]);
+        return emission->py_params[i];
+    }
+
+    return pyg_value_as_pyobject(&param_values[i], copy_boxed);
+}
+
 /* -------------- PyGClosure ----------------- */
 
 static void
@@ -691,21 +847,37 @@ pyg_closure_marshal(GClosure *closure,
 {
     PyGILState_STATE state;
     PyGClosure *pc = (PyGClosure *)closure;
+    PyGSignalEmission *emission;
     PyObject *params, *ret;
-    guint i;
+    guint i, n_params;
+    Py_ssize_t n_extra_args;
 
     state = pyglib_gil_state_ensure();
 
-    /* construct Python tuple for the parameter values */
-    params = PyTuple_New(n_param_values);
-    for (i = 0; i < n_param_values; i++) {
+    emission = pyg_signal_emission_find(param_values);
+
+    /* only convert the parameters the callback accepts */
+    n_params = n_param_values;
+    if (pc->max_params > 0 && (guint) pc->max_params - 1 < n_params)
+        n_params = pc->max_params - 1;
+
+    /* construct Python tuple for the parameter values followed by the
+     * extra arguments */
+    n_extra_args = pc->extra_args ? PyTuple_GET_SIZE(pc->extra_args) : 0;
+    params = PyTuple_New(n_params + n_extra_args);
+    for (i = 0; i < n_extra_args; i++) {
+	PyObject *item = PyTuple_GET_ITEM(pc->extra_args, i);
+	Py_INCREF(item);
+	PyTuple_SET_ITEM(params, n_params + i, item);
+    }
+    for (i = 0; i < n_params; i++) {
 	/* swap in a different initial data for connect_object() */
 	if (i == 0 && G_CCLOSURE_SWAP_DATA(closure)) {
 	    g_return_if_fail(pc->swap_data != NULL);
 	    Py_INCREF(pc->swap_data);
 	    PyTuple_SetItem(params, 0, pc->swap_data);
 	} else {
-	    PyObject *item = pyg_value_as_pyobject(&param_values[i], FALSE);
+	    PyObject *item = pyg_signal_emission_get_param(emission, param_values, i, FALSE);
 
 	    /* error condition */
 	    if (!item) {
@@ -723,13 +895,15 @@ pyg_closure_marshal(GClosure *closure,
 	    PyTuple_SetItem(params, i, item);
 	}
     }
-    /* params passed to function may have extra arguments */
-    if (pc->extra_args) {
-	PyObject *tuple = params;
-	params = PySequence_Concat(tuple, pc->extra_args);
-	Py_DECREF(tuple);
+    if (PYGI_SIGNAL_PROFILER_IS_ENABLED()) {
+        gint64 start_time = pygi_profiler_now();
+        ret = PyObject_CallObject(pc->callback, params);
+        pygi_signal_profiler_record_handler(invocation_hint, param_values,
+                                            pc->callback, &pc->profiler_name,
+                                            start_time, ret == NULL);
+    } else {
+        ret = PyObject_CallObject(pc->callback, params);
     }
-    ret = PyObject_CallObject(pc->callback, params);
     if (ret == NULL) {
 	if (pc->exception_handler)
 	    pc->exception_handler(return_value, n_param_values, param_values);
@@ -757,6 +931,58 @@ pyg_closure_marshal(GClosure *closure,
     pyglib_gil_state_release(state);
 }
 
+/**
+ * pyg_closure_get_max_params:
+ * @callback: a Python callable object
+ * @extra_args: (allow-none): tuple of extra arguments passed after the
+ *     signal parameters
+ *
+ * Inspects the code object of @callback to find out how many signal
+ * parameters it can take, so the parameters it would not accept anyway
+ * don't need to be converted to Python. Callbacks with extra arguments
+ * always get all parameters, so a signature not matching the signal
+ * still raises TypeError instead of the extra arguments taking the place
+ * of signal parameters.
+ *
+ * Returns: the value for PyGClosure.max_params: the number of leading
+ *     signal parameters to pass plus one, or 0 to pass all of them, e.g.
+ *     for callbacks taking *args or which are not plain Python functions
+ *     or methods.
+ */
+gint
+pyg_closure_get_max_params(PyObject *callback, PyObject *extra_args)
+{
+    PyObject *func = callback;
+    PyCodeObject *code;
+    gint max_params;
+
+    if (extra_args != NULL && PyTuple_GET_SIZE(extra_args) > 0)
+        return 0;
+
+    if (PyMethod_Check(callback)) {
+        func = PyMethod_GET_FUNCTION(callback);
+        if (PyMethod_GET_SELF(callback) == NULL)
+            return 0;
+    }
+
+    if (!PyFunction_Check(func))
+        return 0;
+
+    code = (PyCodeObject *)PyFunction_GET_CODE(func);
+    if (code->co_flags & CO_VARARGS)
+        return 0;
+
+    max_params = code->co_argcount;
+    if (func != callback)
+        max_params--;
+
+    /* let the call report the wrong number of arguments */
+    if (max_params < 0)
+        return 0;
+
+    return max_params + 1;
+}
+
 /**
  * pyg_closure_new:
  * callback: a Python callable object
@@ -789,6 +1015,8 @@ pyg_closure_new(PyObject *callback, PyObject *extra_args, PyObject *swap_data)
 	}
 	((PyGClosure *)closure)->extra_args = extra_args;
     }
+    ((PyGClosure *)closure)->max_params =
+        pyg_closure_get_max_params(callback, ((PyGClosure *)closure)->extra_args);
     if (swap_data) {
 	Py_INCREF(swap_data);
 	((PyGClosure *)closure)->swap_data = swap_data;
@@ -797,6 +1025,199 @@ pyg_closure_new(PyObject *callback, PyObject *extra_args, PyObject *swap_data)
     return closure;
 }
 
+/* -------------- PyGCoalescedNotifyClosure ----------------- */
+/* A closure for notify signals which does not call the Python callback
+ * for every change. The names of the changed properties are collected and
+ * the callback is called once from an idle handler with all of them, so
+ * setting many properties in a row doesn't take the GIL for each one.
+ */
+
+typedef struct {
+    PyGClosure pyg_closure;
+    GObject *object;         /* emitting object while a dispatch is pending */
+    GHashTable *changed;     /* set of interned property names */
+    guint idle_id;
+} PyGCoalescedNotifyClosure;
+
+/* notify can be emitted from any thread */
+G_LOCK_DEFINE_STATIC (coalesced_notify);
+
+static gboolean
+pyg_coalesced_notify_dispatch(gpointer data)
+{
+    GClosure *closure = data;
+    PyGCoalescedNotifyClosure *cc = data;
+    PyGClosure *pc = data;
+    PyGILState_STATE state;
+    GHashTable *changed;
+    GHashTableIter iter;
+    GObject *object;
+    const gchar *name;
+    PyObject *py_object, *py_names, *params, *ret;
+    Py_ssize_t i, n_extra_args;
+
+    G_LOCK (coalesced_notify);
+    object = cc->object;
+    changed = cc->changed;
+    cc->object = NULL;
+    cc->changed = NULL;
+    cc->idle_id = 0;
+    G_UNLOCK (coalesced_notify);
+
+    if (object == NULL)
+        return FALSE;
+
+    if (closure->is_invalid)
+        goto out;
+
+    state = pyglib_gil_state_ensure();
+
+    if (pc->callback == NULL)
+        goto out_gil;
+
+    py_names = PySet_New(NULL);
+    if (py_names == NULL) {
+        PyErr_Print();
+        goto out_gil;
+    }
+
+    g_hash_table_iter_init(&iter, changed);
+    while (g_hash_table_iter_next(&iter, (gpointer *)&name, NULL)) {
+        PyObject *py_name = PYGLIB_PyUnicode_FromString(name);
+
+        if (py_name == NULL || PySet_Add(py_names, py_name) < 0) {
+            Py_XDECREF(py_name);
+            Py_DECREF(py_names);
+            PyErr_Print();
+            goto out_gil;
+        }
+        Py_DECREF(py_name);
+    }
+
+    py_object = pygobject_new(object);
+    if (py_object == NULL) {
+        Py_DECREF(py_names);
+        PyErr_Print();
+        goto out_gil;
+    }
+
+    n_extra_args = pc->extra_args ? PyTuple_GET_SIZE(pc->extra_args) : 0;
+    params = PyTuple_New(2 + n_extra_args);
+    if (params == NULL) {
+        Py_DECREF(py_object);
+        Py_DECREF(py_names);
+        PyErr_Print();
+        goto out_gil;
+    }
+    PyTuple_SET_ITEM(params, 0, py_object);
+    PyTuple_SET_ITEM(params, 1, py_names);
+    for (i = 0; i < n_extra_args; i++) {
+        PyObject *item = PyTuple_GET_ITEM(pc->extra_args, i);
+        Py_INCREF(item);
+        PyTuple_SET_ITEM(params, 2 + i, item);
+    }
+
+    ret = PyObject_CallObject(pc->callback, params);
+    if (ret == NULL)
+        PyErr_Print();
+    else
+        Py_DECREF(ret);
+    Py_DECREF(params);
+
+ out_gil:
+    pyglib_gil_state_release(state);
+ out:
+    g_hash_table_destroy(changed);
+    g_object_unref(object);
+    return FALSE;
+}
+
+static void
+pyg_coalesced_notify_marshal(GClosure *closure,
+                             GValue *return_value,
+                             guint n_param_values,
+                             const GValue *param_values,
+                             gpointer invocation_hint,
+                             gpointer marshal_data)
+{
+    PyGCoalescedNotifyClosure *cc = (PyGCoalescedNotifyClosure *)closure;
+    GParamSpec *pspec;
+
+    g_return_if_fail(n_param_values == 2);
+
+    pspec = g_value_get_param(&param_values[1]);
+
+    G_LOCK (coalesced_notify);
+
+    if (cc->changed == NULL) {
+        cc->changed = g_hash_table_new(NULL, NULL);
+        cc->object = g_value_dup_object(&param_values[0]);
+    }
+    g_hash_table_add(cc->changed, (gpointer)g_intern_string(pspec->name));
+
+    if (cc->idle_id == 0) {
+        /* Run before GTK+ relayouts and redraws, so views bound to the
+         * properties are updated in the same frame. */
+        cc->idle_id = g_idle_add_full(G_PRIORITY_HIGH_IDLE,
+                                      pyg_coalesced_notify_dispatch,
+                                      g_closure_ref(closure),
+                                      (GDestroyNotify)g_closure_unref);
+    }
+
+    G_UNLOCK (coalesced_notify);
+}
+
+static void
+pyg_coalesced_notify_finalize(gpointer data, GClosure *closure)
+{
+    PyGCoalescedNotifyClosure *cc = (PyGCoalescedNotifyClosure *)closure;
+
+    /* only left over if the idle source got destroyed without running */
+    if (cc->changed != NULL) {
+        g_hash_table_destroy(cc->changed);
+        g_object_unref(cc->object);
+    }
+}
+
+/**
+ * pyg_coalesced_notify_closure_new:
+ * callback: a Python callable object
+ * extra_args: a tuple of extra arguments, or None/NULL.
+ *
+ * Creates a closure for the notify signal which calls @callback at most
+ * once per main loop iteration with the object and the set of the names
+ * of the properties which changed since the last call, followed by
+ * @extra_args.
+ *
+ * Returns: the new closure.
+ */
+GClosure *
+pyg_coalesced_notify_closure_new(PyObject *callback, PyObject *extra_args)
+{
+    GClosure *closure;
+    PyGClosure *pc;
+
+    g_return_val_if_fail(callback != NULL, NULL);
+    closure = g_closure_new_simple(sizeof(PyGCoalescedNotifyClosure), NULL);
+    g_closure_add_invalidate_notifier(closure, NULL, pyg_closure_invalidate);
+    g_closure_add_finalize_notifier(closure, NULL, pyg_coalesced_notify_finalize);
+    g_closure_set_marshal(closure, pyg_coalesced_notify_marshal);
+
+    pc = (PyGClosure *)closure;
+    Py_INCREF(callback);
+    pc->callback = callback;
+    if (extra_args && extra_args != Py_None) {
+        Py_INCREF(extra_args);
+        if (!PyTuple_Check(extra_args)) {
+            PyObject *tmp = PyTuple_New(1);
+            PyTuple_SetItem(tmp, 0, extra_args);
+            extra_args = tmp;
+        }
+        pc->extra_args = extra_args;
+    }
+    return closure;
+}
+
 /**
  * pyg_closure_set_exception_handler:
  * @closure: a closure created with pyg_closure_new()
@@ -845,6 +1266,7 @@ pyg_signal_class_closure_marshal(GClosure *closure,
     gchar *method_name, *tmp;
     PyObject *method;
     PyObject *params, *ret;
+    PyGSignalEmission *emission;
     guint i, len;
 
     state = pyglib_gil_state_ensure();
@@ -880,9 +1302,10 @@ pyg_signal_class_closure_marshal(GClosure *closure,
 
     /* construct Python tuple for the parameter values; don't copy boxed values
        initially because we'll check after the call to see if a copy is needed. */
+    emission = pyg_signal_emission_find(param_values);
     params = PyTuple_New(n_param_values - 1);
     for (i = 1; i < n_param_values; i++) {
-	PyObject *item = pyg_value_as_pyobject(&param_values[i], FALSE);
+	PyObject *item = pyg_signal_emission_get_param(emission, param_values, i, FALSE);
 
 	/* error condition */
 	if (!item) {
@@ -893,7 +1316,15 @@ pyg_signal_class_closure_marshal(GClosure *closure,
 	PyTuple_SetItem(params, i - 1, item);
     }
 
-    ret = PyObject_CallObject(method, params);
+    if (PYGI_SIGNAL_PROFILER_IS_ENABLED()) {
+        gint64 start_time = pygi_profiler_now();
+        ret = PyObject_CallObject(method, params);
+        pygi_signal_profiler_record_handler(invocation_hint, param_values,
+                                            method, NULL, start_time,
+                                            ret == NULL);
+    } else {
+        ret = PyObject_CallObject(method, params);
+    }
 
     /* Copy boxed values if others ref them, this needs to be done regardless of
        exception status. */
@@ -61,7 +61,24 @@ GType     pyg_type_from_object (PyObject *obj);
 
 int pyg_pyobj_to_unichar_conv (PyObject* py_obj, void* ptr);
 
+/* An emission of a Python defined signal from Python. py_params holds the
+ * Python objects the GValues in params were converted from, or NULL where
+ * converting back would not give an equal object.
+ */
+typedef struct _PyGSignalEmission PyGSignalEmission;
+struct _PyGSignalEmission {
+    const GValue *params;
+    PyObject **py_params;
+    PyGSignalEmission *next;
+};
+
+gboolean pyg_signal_emission_param_reusable(const GValue *value, PyObject *obj);
+void      pyg_signal_emission_push(PyGSignalEmission *emission);
+void      pyg_signal_emission_pop(PyGSignalEmission *emission);
+
 GClosure *pyg_closure_new(PyObject *callback, PyObject *extra_args, PyObject *swap_data);
+gint      pyg_closure_get_max_params(PyObject *callback, PyObject *extra_args);
+GClosure *pyg_coalesced_notify_closure_new(PyObject *callback, PyObject *extra_args);
 GClosure *pyg_signal_class_closure_get(void);
 void      pyg_closure_set_exception_handler(GClosure *closure,
                                             PyClosureExceptionHandler handler);
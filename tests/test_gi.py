@@ -17,6 +17,7 @@ from io import StringIO, BytesIO
 
 import gi
 import gi.overrides
+import gi.profiler
 from gi import PyGIWarning
 from gi import PyGIDeprecationWarning
 from gi.repository import GObject, GLib, Gio
@@ -1454,6 +1455,29 @@ class TestCallbacks(unittest.TestCase):
         self.assertEqual(GIMarshallingTests.callback_return_value_and_multiple_out_parameters(cb),
                          (5, 42, -1000))
 
+    def test_nested_invoke_reuses_state(self):
+        def cb(depth):
+            if depth == 0:
+                return GIMarshallingTests.int_return_max()
+            return GIMarshallingTests.callback_return_value_only(lambda: cb(depth - 1))
+
+        # The first round may need to allocate, repeating it must not.
+        self.assertEqual(cb(20), GLib.MAXINT)
+        stats = gi._gi.invoke_state_pool_stats()
+        self.assertEqual(cb(20), GLib.MAXINT)
+        new_stats = gi._gi.invoke_state_pool_stats()
+        self.assertEqual(new_stats['misses'], stats['misses'])
+        self.assertTrue(new_stats['hits'] > stats['hits'])
+
+    def test_closures_are_recycled(self):
+        GIMarshallingTests.callback_return_value_only(lambda: 1)
+        stats = gi._gi.closure_pool_stats()
+        for i in range(10):
+            self.assertEqual(GIMarshallingTests.callback_return_value_only(lambda: i), i)
+        new_stats = gi._gi.closure_pool_stats()
+        self.assertEqual(new_stats['misses'], stats['misses'])
+        self.assertEqual(new_stats['hits'], stats['hits'] + 10)
+
 
 class TestPointer(unittest.TestCase):
     def test_pointer_in_return(self):
@@ -1767,6 +1791,19 @@ class TestStructure(unittest.TestCase):
 
         del struct
 
+    def test_simple_struct_storage_reuse(self):
+        # storage of discarded instances gets reused and must come back zeroed
+        for i in range(64):
+            struct = GIMarshallingTests.SimpleStruct()
+            self.assertEqual(0, struct.long_)
+            struct.long_ = 42
+            del struct
+
+        structs = [GIMarshallingTests.SimpleStruct() for i in range(4)]
+        for i, struct in enumerate(structs):
+            struct.long_ = i
+        self.assertEqual([0, 1, 2, 3], [s.long_ for s in structs])
+
     def test_nested_struct(self):
         struct = GIMarshallingTests.NestedStruct()
 
@@ -2740,6 +2777,35 @@ class TestKeywordArgs(unittest.TestCase):
         self.assertRaisesMessage(TypeError, "GIMarshallingTests.int_three_in_three_out() got an unexpected keyword argument 'e'",
                                  GIMarshallingTests.int_three_in_three_out, **{'e': 2})
 
+    def test_bound_method_keywords(self):
+        v = GLib.Variant('i', 1)
+        self.assertEqual(v.print_(type_annotate=False), '1')
+        self.assertEqual(GLib.Variant.print_(v, type_annotate=True), 'int32 1')
+        self.assertRaisesMessage(TypeError, "GLib.Variant.print() got multiple values for keyword argument 'type_annotate'",
+                                 v.print_, False, type_annotate=False)
+
+    def test_dynamic_keyword_names(self):
+        # names built at runtime are not interned and have to match by value
+        v = GLib.Variant('i', 1)
+        literal = 'type_annotate'
+        prefix, suffix = 'type_', 'annotate'
+        key = prefix + suffix
+        self.assertFalse(key is literal)
+        self.assertEqual(v.print_(**{key: False}), '1')
+        self.assertEqual(GLib.Variant.print_(v, **{key: True}), 'int32 1')
+
+        key = prefix + 'annotation'
+        self.assertRaisesMessage(TypeError, "GLib.Variant.print() got an unexpected keyword argument 'type_annotation'",
+                                 v.print_, **{key: True})
+
+    def test_interned_keyword_name_mismatch(self):
+        # interned names not matching by identity don't match at all
+        v = GLib.Variant('i', 1)
+        self.assertRaisesMessage(TypeError, "GLib.Variant.print() got an unexpected keyword argument 'type_annotation'",
+                                 v.print_, type_annotation=True)
+        self.assertRaisesMessage(TypeError, "GLib.Variant.print() got an unexpected keyword argument 'annotate'",
+                                 v.print_, **{'annotate': True})
+
     def test_kwargs_are_not_modified(self):
         d = {'b': 2}
         d2 = d.copy()
@@ -2797,6 +2863,232 @@ class TestKeywords(unittest.TestCase):
         self.assertEqual(GLib.IOCondition.IN.value_nicks, ['in'])
 
 
+class TestGILRelease(unittest.TestCase):
+    def test_default_policy(self):
+        # simple getters keep the GIL, functions which can block release it
+        self.assertFalse(gi.get_gil_release(GLib.Variant.get_int32))
+        self.assertTrue(gi.get_gil_release(Gio.File.load_contents))
+        self.assertTrue(gi.get_gil_release(GIMarshallingTests.int_return_max))
+
+    def test_set_gil_release(self):
+        func = GIMarshallingTests.int_in_max
+        self.addCleanup(gi.set_gil_release, func, gi.get_gil_release(func))
+
+        gi.set_gil_release(func, False)
+        self.assertFalse(gi.get_gil_release(func))
+        func(GLib.MAXINT)
+        gi.set_gil_release(func, True)
+        self.assertTrue(gi.get_gil_release(func))
+        func(GLib.MAXINT)
+
+    def test_bound_method(self):
+        v = GLib.Variant('i', 42)
+        self.assertFalse(gi.get_gil_release(v.get_int32))
+        self.assertEqual(v.get_int32(), 42)
+
+    def test_invalid(self):
+        self.assertRaises(TypeError, gi.set_gil_release, len, False)
+        self.assertRaises(TypeError, gi.get_gil_release, None)
+
+
+class TestBasicInArgs(unittest.TestCase):
+    # Exact int, bool and float objects in range are converted inline, all
+    # other values have to behave as with the generic conversion.
+
+    def _assert_overflow(self, message, func, *args):
+        try:
+            func(*args)
+        except OverflowError as e:
+            self.assertEqual(str(e), message)
+        else:
+            self.fail('OverflowError not raised')
+
+    def test_int_out_of_range(self):
+        self._assert_overflow('128 not in range -128 to 127',
+                              GIMarshallingTests.int8_in_max, 128)
+        self._assert_overflow('-1 not in range 0 to 255',
+                              GIMarshallingTests.uint8_in, -1)
+        self._assert_overflow('2147483648 not in range -2147483648 to 2147483647',
+                              GIMarshallingTests.int_three_in_three_out, 2 ** 31, 0, 0)
+        self._assert_overflow('-1 not in range 0 to 4294967295',
+                              GIMarshallingTests.uint32_in, -1)
+        self.assertRaises(OverflowError, GIMarshallingTests.int64_in_max, 2 ** 63)
+        self.assertRaises(OverflowError, GIMarshallingTests.uint64_in, 2 ** 64)
+
+    def test_float_out_of_range(self):
+        self._assert_overflow('1e+40 not in range -3.40282e+38 to 3.40282e+38',
+                              GIMarshallingTests.float_in, 1e40)
+        self._assert_overflow('-1e+40 not in range -3.40282e+38 to 3.40282e+38',
+                              GIMarshallingTests.float_in, -1e40)
+
+    def test_subclasses(self):
+        class IntSubclass(int):
+            pass
+
+        class FloatSubclass(float):
+            pass
+
+        self.assertEqual(GIMarshallingTests.int_three_in_three_out(True, IntSubclass(5), False),
+                         (1, 5, 0))
+        self._assert_overflow('2147483648 not in range -2147483648 to 2147483647',
+                              GIMarshallingTests.int_three_in_three_out,
+                              IntSubclass(2 ** 31), 0, 0)
+        self.assertEqual(GLib.Variant.new_int32(IntSubclass(7)).get_int32(), 7)
+        self.assertEqual(GLib.Variant.new_int32(True).get_int32(), 1)
+        self.assertEqual(GLib.Variant.new_double(FloatSubclass(1.5)).get_double(), 1.5)
+        self.assertEqual(GLib.Variant.new_double(2).get_double(), 2.0)
+        self.assertEqual(GLib.Variant.new_boolean(IntSubclass(2)).get_boolean(), True)
+        self.assertEqual(GLib.Variant.new_boolean(0).get_boolean(), False)
+
+
+class TestDirectCall(unittest.TestCase):
+    # Functions with common signatures are called without libffi, results
+    # have to be the same either way.
+
+    def assertSameResult(self, func, *args):
+        self.addCleanup(gi._gi.set_direct_call, func, True)
+        self.assertFalse(gi._gi.set_direct_call(func, False))
+        expected = func(*args)
+        self.assertTrue(gi._gi.set_direct_call(func, True))
+        result = func(*args)
+        self.assertEqual(result, expected)
+        return result
+
+    def test_return_only(self):
+        self.assertEqual(self.assertSameResult(GIMarshallingTests.int_return_max), GLib.MAXINT)
+        self.assertEqual(self.assertSameResult(GIMarshallingTests.int_return_min), GLib.MININT)
+        self.assertEqual(self.assertSameResult(GIMarshallingTests.uint32_return), GLib.MAXUINT32)
+        self.assertEqual(self.assertSameResult(GIMarshallingTests.boolean_return_true), True)
+        self.assertAlmostEqual(self.assertSameResult(GIMarshallingTests.double_return), GLib.MAXDOUBLE)
+        self.assertEqual(self.assertSameResult(GIMarshallingTests.utf8_none_return), CONSTANT_UTF8)
+
+    def test_in_args(self):
+        self.assertSameResult(GIMarshallingTests.int_in_max, GLib.MAXINT)
+        self.assertSameResult(GIMarshallingTests.uint32_in, GLib.MAXUINT32)
+        self.assertSameResult(GIMarshallingTests.double_in, GLib.MAXDOUBLE)
+        self.assertSameResult(GIMarshallingTests.boolean_in_true, True)
+        self.assertSameResult(GIMarshallingTests.utf8_none_in, CONSTANT_UTF8)
+
+    def test_out_args(self):
+        self.assertEqual(self.assertSameResult(GIMarshallingTests.int_inout_max_min, GLib.MAXINT),
+                         GLib.MININT)
+        self.assertEqual(self.assertSameResult(GIMarshallingTests.boolean_out_true), True)
+
+    def test_object(self):
+        obj = self.assertSameResult(GIMarshallingTests.Object.new, 42)
+        self.assertEqual(obj.props.int, 42)
+        self.assertSameResult(GIMarshallingTests.Object.method, obj)
+
+    def test_unsupported_signature(self):
+        self.assertFalse(gi._gi.set_direct_call(GIMarshallingTests.int_three_in_three_out, True))
+        self.assertEqual(GIMarshallingTests.int_three_in_three_out(1, 2, 3), (1, 2, 3))
+
+
+class TestInvokeMany(unittest.TestCase):
+    def test_function(self):
+        self.assertEqual(gi.invoke_many(GIMarshallingTests.int_three_in_three_out,
+                                        [(1, 2, 3), (4, 5, 6)]),
+                         [(1, 2, 3), (4, 5, 6)])
+        self.assertEqual(gi.invoke_many(GIMarshallingTests.int_return_max, [()] * 100),
+                         [GLib.MAXINT] * 100)
+        self.assertEqual(gi.invoke_many(GIMarshallingTests.int_return_max, iter([])), [])
+
+    def test_method(self):
+        variants = [GLib.Variant('i', i) for i in range(10)]
+        self.assertEqual(gi.invoke_many(GLib.Variant.get_int32, [(v,) for v in variants]),
+                         list(range(10)))
+
+        v = GLib.Variant('i', 42)
+        self.assertEqual(gi.invoke_many(v.print_, [(True,), (False,)]),
+                         ['int32 42', '42'])
+
+    def test_constructor(self):
+        objects = gi.invoke_many(GIMarshallingTests.Object.new, [(1,), (2,)])
+        self.assertEqual([o.props.int for o in objects], [1, 2])
+
+    def test_errors(self):
+        self.assertRaises(TypeError, gi.invoke_many, len, [()])
+        self.assertRaises(TypeError, gi.invoke_many, GIMarshallingTests.int_in_max, 42)
+        self.assertRaises(TypeError, gi.invoke_many, GIMarshallingTests.int_in_max, [42])
+        self.assertRaises(TypeError, gi.invoke_many, GIMarshallingTests.int_three_in_three_out,
+                          [(1, 2, 3), (1, 2)])
+        self.assertRaises(OverflowError, gi.invoke_many, GIMarshallingTests.int_in_max,
+                          [(GLib.MAXINT,), (GLib.MAXINT + 1,)])
+
+    def test_gerror(self):
+        self.assertRaises(GLib.Error, gi.invoke_many, GIMarshallingTests.gerror, [(), ()])
+
+    def test_caller_allocates(self):
+        # caller-allocated arguments are never batched, so this only checks
+        # that the item-by-item fallback returns the results and errors
+        self.assertEqual(gi.invoke_many(GIMarshallingTests.gvalue_out_caller_allocates,
+                                        [()] * 3),
+                         [42] * 3)
+        self.assertRaises(TypeError, gi.invoke_many,
+                          GIMarshallingTests.gvalue_out_caller_allocates,
+                          [(), (), (1,)])
+
+
+@unittest.skipUnless(gi.profiler.is_available(), 'built with --disable-profiler')
+class TestProfiler(unittest.TestCase):
+    def setUp(self):
+        import gi.profiler
+        self.profiler = gi.profiler
+        self.was_enabled = gi.profiler.is_enabled()
+        gi.profiler.reset()
+        gi.profiler.enable()
+
+    def tearDown(self):
+        if not self.was_enabled:
+            self.profiler.disable()
+        self.profiler.reset()
+
+    def test_calls(self):
+        for i in range(5):
+            GIMarshallingTests.int_in_max(GLib.MAXINT)
+        self.assertRaises(OverflowError, GIMarshallingTests.int_in_max, GLib.MAXINT + 1)
+        GIMarshallingTests.int_three_in_three_out(1, 2, 3)
+
+        stats = self.profiler.get_stats()
+        self.assertEqual(stats['GIMarshallingTests.int_in_max'].calls, 6)
+        self.assertEqual(stats['GIMarshallingTests.int_three_in_three_out'].calls, 1)
+        for value in stats['GIMarshallingTests.int_in_max'][2:]:
+            self.assertTrue(value >= 0)
+
+        self.profiler.disable()
+        GIMarshallingTests.int_in_max(GLib.MAXINT)
+        self.assertEqual(self.profiler.get_stats()['GIMarshallingTests.int_in_max'].calls, 6)
+
+        self.profiler.reset()
+        self.assertFalse('GIMarshallingTests.int_in_max' in self.profiler.get_stats())
+
+    def test_closure_calls(self):
+        GIMarshallingTests.callback_return_value_only(lambda: 5)
+        GIMarshallingTests.callback_return_value_only(lambda: 5)
+
+        stats = self.profiler.get_stats()
+        self.assertEqual(stats['GIMarshallingTests.callback_return_value_only'].calls, 2)
+        self.assertEqual(sorted(s.closure_calls for s in stats.values()), [0, 2])
+
+    def test_dump(self):
+        class Output(object):
+            def __init__(self):
+                self.lines = []
+
+            def write(self, data):
+                self.lines.append(data)
+
+        GIMarshallingTests.int_in_max(GLib.MAXINT)
+        for i in range(3):
+            GIMarshallingTests.int_return_max()
+
+        out = Output()
+        self.profiler.dump(out, sort='calls')
+        self.assertEqual(len(out.lines), 3)
+        self.assertTrue(out.lines[1].rstrip().endswith('GIMarshallingTests.int_return_max'))
+        self.assertTrue(out.lines[2].rstrip().endswith('GIMarshallingTests.int_in_max'))
+
+
 class TestModule(unittest.TestCase):
     def test_path(self):
         self.assertTrue(GIMarshallingTests.__path__.endswith('GIMarshallingTests-1.0.typelib'),
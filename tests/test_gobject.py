@@ -420,6 +420,62 @@ class TestContextManagers(unittest.TestCase):
         self.assertEqual(self.tracking, [2])
 
 
+class TestCoalescedNotify(unittest.TestCase):
+    class Object(GObject.GObject):
+        __gsignals__ = {'changed': (GObject.SignalFlags.RUN_FIRST, None, ())}
+
+        int_prop = GObject.Property(default=0, type=int)
+        str_prop = GObject.Property(default='', type=str)
+
+    def setUp(self):
+        self.calls = []
+        self.obj = self.Object()
+
+    def on_notify(self, obj, names, *args):
+        self.calls.append((obj, names) + args)
+
+    def iterate(self):
+        context = GLib.MainContext.default()
+        while context.iteration(False):
+            pass
+
+    def test_coalesce(self):
+        self.obj.connect('notify', self.on_notify, 'data', coalesce=True)
+        for i in range(10):
+            self.obj.props.int_prop = i
+        self.obj.props.str_prop = 'foo'
+        self.assertEqual(self.calls, [])
+
+        self.iterate()
+        self.assertEqual(self.calls, [(self.obj, set(['int-prop', 'str-prop']), 'data')])
+
+        self.obj.props.int_prop = 42
+        self.iterate()
+        self.assertEqual(len(self.calls), 2)
+        self.assertEqual(self.calls[1][1], set(['int-prop']))
+
+    def test_detail(self):
+        self.obj.connect('notify::str-prop', self.on_notify, coalesce=True)
+        self.obj.props.int_prop = 1
+        self.obj.props.str_prop = 'foo'
+        self.iterate()
+        self.assertEqual(self.calls, [(self.obj, set(['str-prop']))])
+
+    def test_disconnect(self):
+        handler = self.obj.connect('notify', self.on_notify, coalesce=True)
+        self.obj.props.int_prop = 1
+        self.obj.disconnect(handler)
+        self.iterate()
+        self.assertEqual(self.calls, [])
+
+    def test_errors(self):
+        self.assertRaises(TypeError, self.obj.connect, 'notify', self.on_notify, foo=True)
+        self.assertRaises(TypeError, self.obj.connect, 'notify', self.on_notify,
+                          coalesce=True, foo=True)
+        self.assertRaises(TypeError, self.obj.connect, 'changed', self.on_notify,
+                          coalesce=True)
+
+
 @unittest.skipUnless(hasattr(GObject.Binding, 'unbind'),
                      'Requires newer GLib which has g_binding_unbind')
 class TestPropertyBindings(unittest.TestCase):
@@ -136,6 +136,32 @@ class TestPropertyObject(unittest.TestCase):
     def test_hasattr_on_class(self):
         self.assertTrue(hasattr(PropertyObject.props, "normal"))
 
+    def test_repeated_lookup(self):
+        # property lookups are cached per type, including missing ones
+        obj = PropertyObject()
+        for i in range(3):
+            obj.props.normal = str(i)
+            self.assertEqual(obj.props.normal, str(i))
+            self.assertEqual(obj.props.construct, 'default')
+            self.assertRaises(AttributeError, getattr, obj.props, 'missing')
+            self.assertEqual(PropertyObject.props.normal.name, 'normal')
+            self.assertEqual(PropertyObject.props.construct_only.name,
+                             'construct-only')
+
+    def test_repeated_construct(self):
+        # construct properties are looked up once per type and the
+        # parameter buffer is reused, also after failures
+        for i in range(3):
+            obj = PropertyObject(normal=str(i), construct_only='c%d' % i,
+                                 uint64=i)
+            self.assertEqual(obj.props.normal, str(i))
+            self.assertEqual(obj.props.construct_only, 'c%d' % i)
+            self.assertEqual(obj.props.uint64, i)
+            self.assertRaises(TypeError, PropertyObject, normal='a', missing=1)
+            self.assertRaises(TypeError, PropertyObject, normal='a', uint64='b')
+            obj = GObject.new(PropertyObject, construct_only='x')
+            self.assertEqual(obj.props.construct_only, 'x')
+
     def test_set_on_class(self):
         def set(obj):
             obj.props.normal = "foobar"
@@ -730,6 +756,42 @@ class TestProperty(unittest.TestCase):
         self.assertEqual(o1.prop, 'value')
         self.assertEqual(o2.prop, 'default')
 
+    def test_set_notify(self):
+        class C(GObject.GObject):
+            str = GObject.Property(type=str)
+            int = GObject.Property(type=int, minimum=0, maximum=10)
+            obj = GObject.Property(type=GObject.GObject)
+
+        o = C()
+        notified = []
+        o.connect('notify', lambda o, pspec: notified.append(pspec.name))
+
+        o.str = 'value'
+        o.int = 5
+        o.obj = o
+        self.assertEqual(notified, ['str', 'int', 'obj'])
+        self.assertEqual(o.str, 'value')
+        self.assertEqual(o.int, 5)
+        self.assertTrue(o.obj is o)
+        o.obj = None
+
+        # values needing conversion still go through the GValue
+        del notified[:]
+        o.int = True
+        self.assertEqual(o.int, 1)
+        self.assertEqual(type(o.int), int)
+        self.assertRaises(TypeError, setattr, o, 'int', 'five')
+        self.assertRaises(TypeError, setattr, o, 'obj', object())
+        self.assertEqual(notified, ['int'])
+
+        del notified[:]
+        o.freeze_notify()
+        o.str = 'a'
+        o.str = 'b'
+        self.assertEqual(notified, [])
+        o.thaw_notify()
+        self.assertEqual(notified, ['str'])
+
     def test_object_property(self):
         class PropertyObject(GObject.GObject):
             obj = GObject.Property(type=GObject.GObject)
@@ -1134,6 +1196,17 @@ class CPropertiesTestBase(object):
         obj = GIMarshallingTests.PropertiesObject(some_boxed_struct=struct1)
         self.assertEqual(self.get_prop(obj, 'some-boxed-struct').long_, 1)
 
+    def test_boxed_struct_repeated(self):
+        # the introspection data of the property is looked up once
+        for i in range(3):
+            obj = GIMarshallingTests.PropertiesObject()
+            struct = GIMarshallingTests.BoxedStruct()
+            struct.long_ = i
+            self.set_prop(obj, 'some-boxed-struct', struct)
+            self.assertEqual(self.get_prop(obj, 'some-boxed-struct').long_, i)
+            self.set_prop(obj, 'some-object', self.obj)
+            self.assertEqual(self.get_prop(obj, 'some-object'), self.obj)
+
     def test_boxed_glist(self):
         self.assertEqual(self.get_prop(self.obj, 'some-boxed-glist'), [])
 
@@ -1259,6 +1332,59 @@ class CPropertiesTestBase(object):
         self.assertRaises(TypeError, self.set_prop, obj, 'some-object', 'not_an_object')
 
 
+class TestPropertyDescriptors(unittest.TestCase):
+    def test_install(self):
+        class Obj(GIMarshallingTests.PropertiesObject):
+            pass
+
+        # the instance struct fields are attributes already
+        GObject.install_property_descriptors(Obj)
+        self.assertFalse('some_int' in Obj.__dict__)
+
+        GObject.install_property_descriptors(
+            Obj, ['some_int', 'some-boxed-struct', 'some_object', 'some_double'])
+        self.assertTrue(isinstance(Obj.__dict__['some_int'],
+                                   GObject.GPropertyDescriptor))
+        self.assertEqual(Obj.some_int.name, 'some-int')
+        self.assertEqual(Obj.__dict__['some_int'].pspec.name, 'some-int')
+
+        obj = Obj(some_int=3)
+        self.assertEqual(obj.some_int, 3)
+        obj.some_int = 5
+        self.assertEqual(obj.props.some_int, 5)
+        obj.some_double = 1.5
+        self.assertEqual(obj.some_double, 1.5)
+
+        struct = GIMarshallingTests.BoxedStruct()
+        struct.long_ = 2
+        obj.some_boxed_struct = struct
+        self.assertEqual(obj.some_boxed_struct.long_, 2)
+
+        other = GObject.Object()
+        obj.some_object = other
+        self.assertEqual(obj.some_object, other)
+
+        self.assertRaises(TypeError, setattr, obj, 'some_int', 'foo')
+        self.assertRaises(TypeError, delattr, obj, 'some_int')
+        self.assertRaises(TypeError, Obj.__dict__['some_int'].__get__, other)
+        self.assertRaises(AttributeError, GObject.install_property_descriptors,
+                          Obj, ['missing'])
+
+    def test_python_property(self):
+        class Obj(GObject.Object):
+            value = GObject.Property(type=int, default=1)
+
+        class Sub(Obj):
+            pass
+
+        # Python properties have their own descriptors already
+        self.assertRaises(TypeError, GObject.install_property_descriptors,
+                          Sub, ['value'])
+        GObject.install_property_descriptors(Sub)
+        self.assertFalse('value' in Sub.__dict__)
+        self.assertEqual(Sub().value, 1)
+
+
 class TestCPropsAccessor(CPropertiesTestBase, unittest.TestCase):
     # C property tests using the "props" accessor.
     def get_prop(self, obj, name):
@@ -1,15 +1,18 @@
 # -*- Mode: Python -*-
 
 import gc
+import functools
 import unittest
 import sys
 import weakref
 
 from gi.repository import GObject, GLib
 from gi import _signalhelper as signalhelper
+import gi.profiler
 import testhelper
 from compathelper import _long
-from helper import capture_glib_warnings, capture_gi_deprecation_warnings
+from helper import capture_glib_warnings, capture_gi_deprecation_warnings, \
+    capture_exceptions
 
 try:
     import cairo
@@ -72,6 +75,182 @@ class TestChaining(unittest.TestCase):
 # This is for bug 153718
 
 
+class TestHandlerArity(unittest.TestCase):
+    # Handlers only get the signal parameters they can take
+    def setUp(self):
+        self.calls = []
+
+    def _method_no_params(self):
+        self.calls.append(())
+
+    def test_fewer_params(self):
+        inst = C()
+        inst.connect('my_signal', lambda obj: self.calls.append((obj,)))
+        inst.connect('my_signal', lambda: self.calls.append(()))
+        inst.connect('my_signal', self._method_no_params)
+        inst.emit('my_signal', 42)
+        self.assertEqual(self.calls, [(inst,), (), ()])
+
+    def test_extra_args(self):
+        # handlers with user data get all signal parameters, so a wrong
+        # signature isn't hidden by the user data taking their place
+        inst = C()
+        inst.connect('my_signal', lambda obj, data: self.calls.append((obj, data)), 'data')
+        inst.connect('my_signal', lambda obj, arg, data: self.calls.append((obj, arg, data)), 'data')
+        with capture_exceptions() as exc:
+            inst.emit('my_signal', 42)
+        self.assertEqual([e.type for e in exc], [TypeError])
+        self.assertEqual(self.calls, [(inst, 42, 'data')])
+
+    def test_all_params(self):
+        inst = C()
+        inst.connect('my_signal', lambda *args: self.calls.append(args))
+        inst.connect('my_signal', lambda obj, arg=None, *args: self.calls.append((obj, arg) + args), 'data')
+        inst.emit('my_signal', 42)
+        self.assertEqual(self.calls, [(inst, 42), (inst, 42, 'data')])
+
+
+class TestEmitParamReuse(unittest.TestCase):
+    # Handlers of Python signals get the objects passed to emit() back
+    class Emitter(GObject.GObject):
+        __gsignals__ = {
+            'params': (GObject.SignalFlags.RUN_LAST, None,
+                       (int, str, object, GObject.GObject)),
+        }
+
+        def __init__(self):
+            GObject.GObject.__init__(self)
+            self.class_args = None
+
+        def do_params(self, *args):
+            self.class_args = args
+
+    def test_identity(self):
+        inst = self.Emitter()
+        other = GObject.GObject()
+        number = 2 ** 20 + 1
+        string = ''.join(['py', 'gobject'])
+        obj = object()
+        args = []
+        inst.connect('params', lambda *a: args.append(a))
+        inst.emit('params', number, string, obj, other)
+
+        self.assertEqual(len(args), 1)
+        for value, expected in zip(args[0], (inst, number, string, obj, other)):
+            self.assertTrue(value is expected)
+        for value, expected in zip(inst.class_args, (number, string, obj, other)):
+            self.assertTrue(value is expected)
+
+    def test_converted(self):
+        class MyInt(int):
+            pass
+
+        inst = self.Emitter()
+        args = []
+        inst.connect('params', lambda *a: args.append(a))
+        inst.emit('params', MyInt(3), 'a\0b', None, None)
+
+        self.assertEqual(args, [(inst, 3, 'a', None, None)])
+        self.assertEqual(type(args[0][1]), int)
+
+    @unittest.skipUnless(sys.maxsize > 2 ** 32, 'requires 64 bit longs')
+    def test_out_of_range(self):
+        # G_TYPE_INT values are truncated, so handlers must get the value
+        # the GValue holds, not the object passed to emit()
+        inst = self.Emitter()
+        args = []
+        inst.connect('params', lambda *a: args.append(a))
+        inst.emit('params', 2 ** 32 + 5, '', None, None)
+
+        self.assertEqual(args, [(inst, 5, '', None, None)])
+        self.assertEqual(inst.class_args, (5, '', None, None))
+
+
+@unittest.skipUnless(gi.profiler.is_available(), 'built with --disable-profiler')
+class TestSignalProfiler(unittest.TestCase):
+    def setUp(self):
+        import gi.profiler
+        self.profiler = gi.profiler
+        self.was_enabled = gi.profiler.signals_enabled()
+        gi.profiler.reset_signals()
+        gi.profiler.enable_signals()
+
+    def tearDown(self):
+        if not self.was_enabled:
+            self.profiler.disable_signals()
+        self.profiler.reset_signals()
+
+    def _handler(self, obj, arg):
+        if arg < 0:
+            raise ValueError(arg)
+
+    def test_handlers(self):
+        class Stderr(object):
+            def write(self, data):
+                pass
+
+        inst = C()
+        inst.connect('my_signal', self._handler)
+        type_name = GObject.type_name(C)
+
+        old_stderr = sys.stderr
+        sys.stderr = Stderr()
+        try:
+            for arg in (1, 2, -1):
+                inst.emit('my_signal', arg)
+        finally:
+            sys.stderr = old_stderr
+
+        stats = self.profiler.get_signal_stats()
+        self.assertEqual(len(stats), 3)
+        emission = stats[(type_name, 'my_signal', None)]
+        self.assertEqual(emission.calls, 3)
+
+        handlers = dict((key[2], value) for key, value in stats.items()
+                        if key[2] is not None)
+        self.assertEqual(len(handlers), 2)
+        for name, value in handlers.items():
+            self.assertEqual(value.calls, 3)
+            self.assertTrue(0 <= value.max <= value.total <= emission.total)
+            if name.endswith('_handler'):
+                self.assertTrue(name.startswith('test_signal.'))
+                self.assertEqual(value.exceptions, 1)
+            else:
+                self.assertTrue(name.endswith('do_my_signal'))
+                self.assertEqual(value.exceptions, 0)
+
+        self.profiler.disable_signals()
+        inst.emit('my_signal', 1)
+        self.assertEqual(self.profiler.get_signal_stats()[(type_name, 'my_signal', None)].calls, 3)
+
+        self.profiler.reset_signals()
+        self.assertEqual(self.profiler.get_signal_stats(), {})
+
+    def test_raising_callable(self):
+        # looking up the name of a handler without __name__ must keep the
+        # exception it raised
+        class Handler(object):
+            def __call__(self, obj, arg):
+                raise ValueError(arg)
+
+        def raise_error(obj, arg):
+            raise ValueError(arg)
+
+        for handler, name in ((Handler(), 'Handler'),
+                              (functools.partial(raise_error), 'functools.partial')):
+            inst = C()
+            inst.connect('my_signal', handler)
+            with capture_exceptions() as exc:
+                inst.emit('my_signal', 1)
+                inst.emit('my_signal', 2)
+            self.assertEqual([e.type for e in exc], [ValueError, ValueError])
+
+            stats = self.profiler.get_signal_stats()
+            handler_stats = stats[(GObject.type_name(C), 'my_signal', name)]
+            self.assertEqual(handler_stats.exceptions, 2)
+            self.profiler.reset_signals()
+
+
 class TestGSignalsError(unittest.TestCase):
     def test_invalid_type(self, *args):
         def foo():
@@ -7,7 +7,7 @@ import warnings
 from gi.repository import GLib
 from gi import PyGIDeprecationWarning
 
-from helper import capture_glib_warnings
+from helper import capture_glib_warnings, capture_exceptions
 
 
 class Idle(GLib.Idle):
@@ -224,6 +224,62 @@ class TestSource(unittest.TestCase):
         del source
         self.assertTrue(self.finalized)
 
+    def test_partial_hooks(self):
+        # prepare and check are optional, missing ones are skipped
+        calls = []
+
+        class S(GLib.Source):
+            def check(s):
+                calls.append('check')
+                return True
+
+            def dispatch(s, callback, args):
+                calls.append('dispatch')
+                return False
+
+        class T(S):
+            def dispatch(s, callback, args):
+                calls.append('T.dispatch')
+                return S.dispatch(s, callback, args)
+
+        context = GLib.MainContext()
+        for source_type in (S, T):
+            source = source_type()
+            source.attach(context)
+            while context.iteration(False):
+                pass
+            self.assertTrue(source.is_destroyed())
+
+        self.assertEqual(calls, ['check', 'dispatch',
+                                 'check', 'T.dispatch', 'dispatch'])
+
+    def test_instance_hooks(self):
+        # hooks set on the instance take precedence over the class
+        calls = []
+
+        class S(GLib.Source):
+            def check(s):
+                calls.append('S.check')
+                return False
+
+            def dispatch(s, callback, args):
+                calls.append('dispatch')
+                return False
+
+        def check():
+            calls.append('check')
+            return True
+
+        context = GLib.MainContext()
+        source = S()
+        source.prepare = lambda: (False, 0)
+        source.check = check
+        source.attach(context)
+        while context.iteration(False):
+            pass
+        self.assertTrue(source.is_destroyed())
+        self.assertEqual(calls, ['check', 'dispatch'])
+
     @unittest.skip('https://bugzilla.gnome.org/show_bug.cgi?id=722387')
     def test_python_unref_with_active_source(self):
         # Tests a Python derived Source which is free'd in the context of
@@ -281,6 +337,95 @@ class TestSource(unittest.TestCase):
         self.assertEqual(source.kwarg, 2)
 
 
+class TestIdleBatched(unittest.TestCase):
+    def test_order_and_remove(self):
+        calls = []
+        repeat = [2]
+
+        def cb(*args):
+            calls.append(args)
+
+        def cb_repeat():
+            calls.append('repeat')
+            repeat[0] -= 1
+            return repeat[0] > 0
+
+        ml = GLib.MainLoop()
+        GLib.idle_add_batched(cb, 1)
+        removed = GLib.idle_add_batched(cb, 2)
+        GLib.idle_add_batched(cb_repeat)
+        GLib.idle_add_batched(cb, 3, 'a')
+        GLib.idle_add(lambda: calls.append('idle'))
+        GLib.timeout_add(50, ml.quit)
+
+        self.assertTrue(isinstance(removed, GLib.IdleBatchHandle))
+        self.assertEqual(GLib.source_remove(removed), True)
+        self.assertEqual(GLib.source_remove(removed), False)
+
+        ml.run()
+        self.assertEqual(calls, [(1,), 'repeat', (3, 'a'), 'idle', 'repeat'])
+
+    def test_priority(self):
+        calls = []
+        ml = GLib.MainLoop()
+        GLib.idle_add(lambda: calls.append('idle'))
+        GLib.idle_add_batched(lambda: calls.append('high'),
+                              priority=GLib.PRIORITY_HIGH)
+        GLib.timeout_add(50, ml.quit)
+        ml.run()
+        self.assertEqual(calls, ['high', 'idle'])
+
+    def test_base_exception(self):
+        class Abort(BaseException):
+            pass
+
+        def abort():
+            raise Abort()
+
+        calls = []
+        ml = GLib.MainLoop()
+        GLib.idle_add_batched(abort)
+        GLib.idle_add_batched(calls.append, 1)
+        GLib.timeout_add(50, ml.quit)
+        with capture_exceptions() as exc:
+            ml.run()
+        self.assertEqual([e.type for e in exc], [Abort])
+        self.assertEqual(calls, [1])
+
+        GLib.idle_add_batched(calls.append, 2)
+        GLib.timeout_add(50, ml.quit)
+        ml.run()
+        self.assertEqual(calls, [1, 2])
+
+    def test_remove_releases_callback(self):
+        handle = GLib.idle_add_batched(lambda *args: None, 1)
+        self.assertTrue(handle.remove())
+        self.assertEqual(handle._function, None)
+        self.assertEqual(handle._user_data, None)
+
+    def test_threads(self):
+        import threading
+
+        results = []
+        ml = GLib.MainLoop()
+
+        def worker(n):
+            for i in range(100):
+                GLib.idle_add_batched(results.append, (n, i))
+
+        threads = [threading.Thread(target=worker, args=(n,)) for n in range(4)]
+        for thread in threads:
+            thread.start()
+        for thread in threads:
+            thread.join()
+
+        GLib.timeout_add(50, ml.quit)
+        ml.run()
+        self.assertEqual(len(results), 400)
+        for n in range(4):
+            self.assertEqual([i for m, i in results if m == n], list(range(100)))
+
+
 class TestUserData(unittest.TestCase):
     def test_idle_no_data(self):
         ml = GLib.MainLoop()